@@ -312,6 +312,88 @@ extern "C" {
         Z3_CATCH_RETURN(Z3_L_UNDEF);
     }
     
+    Z3_lbool Z3_API Z3_solver_get_consequences(Z3_context c, Z3_solver s,
+                                               Z3_ast_vector assumptions,
+                                               Z3_ast_vector variables,
+                                               Z3_ast_vector consequences) {
+        Z3_TRY;
+        LOG_Z3_solver_get_consequences(c, s, assumptions, variables, consequences);
+        ast_manager& m = mk_c(c)->m();
+        RESET_ERROR_CODE();
+        CHECK_SEARCHING(c);
+        init_solver(c, s);
+        expr_ref_vector _assumptions(m), _consequences(m), _variables(m);
+        ast_ref_vector const& __assumptions = to_ast_vector_ref(assumptions);
+        for (unsigned i = 0; i < __assumptions.size(); ++i) {
+            if (!is_expr(__assumptions[i])) {
+                SET_ERROR_CODE(Z3_INVALID_ARG);
+                return Z3_L_UNDEF;
+            }
+            _assumptions.push_back(to_expr(__assumptions[i]));
+        }
+        ast_ref_vector const& __variables = to_ast_vector_ref(variables);
+        for (unsigned i = 0; i < __variables.size(); ++i) {
+            if (!is_expr(__variables[i])) {
+                SET_ERROR_CODE(Z3_INVALID_ARG);
+                return Z3_L_UNDEF;
+            }
+            _variables.push_back(to_expr(__variables[i]));
+        }
+        lbool result = l_undef;
+        unsigned timeout     = to_solver(s)->m_params.get_uint("timeout", mk_c(c)->get_timeout());
+        unsigned rlimit      = to_solver(s)->m_params.get_uint("rlimit", mk_c(c)->get_rlimit());
+        bool     use_ctrl_c  = to_solver(s)->m_params.get_bool("ctrl_c", false);
+        cancel_eh<reslimit> eh(mk_c(c)->m().limit());
+        api::context::set_interruptable si(*(mk_c(c)), eh);
+        {
+            scoped_ctrl_c ctrlc(eh, false, use_ctrl_c);
+            scoped_timer timer(timeout, &eh);
+            scoped_rlimit _rlimit(mk_c(c)->m().limit(), rlimit);
+            try {
+                result = to_solver_ref(s)->get_consequences(_assumptions, _variables, _consequences);
+            }
+            catch (z3_exception & ex) {
+                mk_c(c)->handle_exception(ex);
+                return Z3_L_UNDEF;
+            }
+        }
+        for (unsigned i = 0; i < _consequences.size(); ++i) {
+            to_ast_vector_ref(consequences).push_back(_consequences[i].get());
+        }
+        return static_cast<Z3_lbool>(result);
+        Z3_CATCH_RETURN(Z3_L_UNDEF);
+    }
+
+    Z3_ast Z3_API Z3_solver_cube(Z3_context c, Z3_solver s, unsigned depth) {
+        Z3_TRY;
+        LOG_Z3_solver_cube(c, s, depth);
+        ast_manager& m = mk_c(c)->m();
+        RESET_ERROR_CODE();
+        CHECK_SEARCHING(c);
+        init_solver(c, s);
+        expr_ref result(m);
+        unsigned timeout     = to_solver(s)->m_params.get_uint("timeout", mk_c(c)->get_timeout());
+        unsigned rlimit      = to_solver(s)->m_params.get_uint("rlimit", mk_c(c)->get_rlimit());
+        bool     use_ctrl_c  = to_solver(s)->m_params.get_bool("ctrl_c", false);
+        cancel_eh<reslimit> eh(mk_c(c)->m().limit());
+        api::context::set_interruptable si(*(mk_c(c)), eh);
+        {
+            scoped_ctrl_c ctrlc(eh, false, use_ctrl_c);
+            scoped_timer timer(timeout, &eh);
+            scoped_rlimit _rlimit(mk_c(c)->m().limit(), rlimit);
+            try {
+                result = to_solver_ref(s)->cube(depth);
+            }
+            catch (z3_exception & ex) {
+                mk_c(c)->handle_exception(ex);
+                RETURN_Z3(0);
+            }
+        }
+        mk_c(c)->save_ast_trail(result);
+        RETURN_Z3(of_ast(result));
+        Z3_CATCH_RETURN(0);
+    }
+
     Z3_model Z3_API Z3_solver_get_model(Z3_context c, Z3_solver s) {
         Z3_TRY;
         LOG_Z3_solver_get_model(c, s);
@@ -5839,6 +5839,43 @@ extern "C" {
     Z3_lbool Z3_API Z3_solver_check_assumptions(Z3_context c, Z3_solver s,
                                                 unsigned num_assumptions, Z3_ast const assumptions[]);
 
+    /**
+       \brief Retrieve the consequences of the assertions in the given solver and the assumptions.
+
+       For each variable \c v in \c variables whose value is implied by the assertions and 
+       the assumptions, an implication \ccode{(=> (and a_1 ... a_k) (= v val))} is added to 
+       \c consequences, where \c a_1, ..., \c a_k are assumptions that imply the value \c val.
+       For Boolean variables the implied literal is \c v or \ccode{(not v)}.
+       Variables whose value is not fixed are omitted.
+
+       The function returns Z3_L_FALSE if the assertions and assumptions are unsatisfiable,
+       and Z3_L_UNDEF if one of the satisfiability checks it performs fails.
+
+       \sa Z3_solver_check_assumptions
+
+       def_API('Z3_solver_get_consequences', INT, (_in(CONTEXT), _in(SOLVER), _in(AST_VECTOR), _in(AST_VECTOR), _in(AST_VECTOR)))
+    */
+    Z3_lbool Z3_API Z3_solver_get_consequences(Z3_context c, Z3_solver s,
+                                               Z3_ast_vector assumptions,
+                                               Z3_ast_vector variables,
+                                               Z3_ast_vector consequences);
+
+    /**
+       \brief Return a cube that splits the search space of the given solver.
+
+       The cube is a conjunction of at most \c depth literals. The result is \c false if the 
+       assertions are unsatisfiable, and \c true if the solver does not split them.
+       Asserting the negation of each cube before retrieving the next one enumerates
+       a partition of the problem: the assertions are satisfiable iff they are satisfiable
+       together with one of the cubes. The cubes can be solved independently, for
+       example by different processes.
+
+       \sa Z3_solver_check
+
+       def_API('Z3_solver_cube', AST, (_in(CONTEXT), _in(SOLVER), _in(UINT)))
+    */
+    Z3_ast Z3_API Z3_solver_cube(Z3_context c, Z3_solver s, unsigned depth);
+
     /**
        \brief Retrieve congruence class representatives for terms.
 
@@ -281,6 +281,18 @@ bool pb_util::has_unit_coefficients(func_decl* f) const {
     return true;
 }
 
+bool pb_util::has_unsigned_coefficients(func_decl* f) const {
+    if (!get_k(f).is_unsigned()) return false;
+    rational sum(0);
+    unsigned sz = f->get_arity();
+    for (unsigned i = 0; i < sz; ++i) {
+        rational c = get_coeff(f, i);
+        if (!c.is_unsigned()) return false;
+        sum += c;
+    }
+    return sum < rational(UINT_MAX);
+}
+
 app* pb_util::mk_fresh_bool() {
     symbol name = m.mk_fresh_var_name("pb");
     func_decl_info info(m_fid, OP_PB_AUX_BOOL, 0, 0);
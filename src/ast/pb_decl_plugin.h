@@ -108,6 +108,12 @@ public:
     rational get_coeff(func_decl* a, unsigned index) const; 
     bool has_unit_coefficients(func_decl* f) const;
     bool has_unit_coefficients(expr* f) const { return is_app(f) && has_unit_coefficients(to_app(f)->get_decl()); }
+    /**
+       \brief Return true if the bound and the coefficients of f are unsigned integers,
+       and the sum of the coefficients is less than UINT_MAX.
+    */
+    bool has_unsigned_coefficients(func_decl* f) const;
+    bool has_unsigned_coefficients(expr* f) const { return is_app(f) && has_unsigned_coefficients(to_app(f)->get_decl()); }
 
 
     bool is_eq(func_decl* f) const;
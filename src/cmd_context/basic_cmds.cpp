@@ -747,6 +747,69 @@ public:
     }
 };
 
+class get_consequences_cmd : public cmd {
+    ptr_vector<expr> m_assumptions;
+    ptr_vector<expr> m_variables;
+    unsigned         m_count;
+public:
+    get_consequences_cmd():
+        cmd("get-consequences"),
+        m_count(0) {
+    }
+    virtual char const * get_usage() const { return "(<boolean-variable>*) (<variable>*)"; }
+    virtual char const * get_descr(cmd_context & ctx) const { return "retrieve consequences that fix values for supplied variables"; }
+    virtual unsigned get_arity() const { return 2; }
+    virtual cmd_arg_kind next_arg_kind(cmd_context & ctx) const { return CPK_EXPR_LIST; }
+    virtual void set_next_arg(cmd_context & ctx, unsigned num, expr * const * tlist) {
+        if (m_count == 0) {
+            m_assumptions.append(num, tlist);
+            ++m_count;
+        }
+        else {
+            m_variables.append(num, tlist);
+        }
+    }
+    virtual void failure_cleanup(cmd_context & ctx) {}
+    virtual void execute(cmd_context & ctx) {
+        ast_manager& m = ctx.m();
+        expr_ref_vector assumptions(m), variables(m), consequences(m);
+        assumptions.append(m_assumptions.size(), m_assumptions.c_ptr());
+        variables.append(m_variables.size(), m_variables.c_ptr());
+        ctx.get_consequences(assumptions, variables, consequences);
+        ctx.regular_stream() << "(";
+        for (unsigned i = 0; i < consequences.size(); ++i) {
+            if (i > 0) ctx.regular_stream() << "\n ";
+            ctx.display(ctx.regular_stream(), consequences.get(i), 1);
+        }
+        ctx.regular_stream() << ")" << std::endl;
+    }
+    virtual void prepare(cmd_context & ctx) { reset(ctx); }
+    virtual void reset(cmd_context& ctx) { m_assumptions.reset(); m_variables.reset(); m_count = 0; }
+    virtual void finalize(cmd_context & ctx) {}
+};
+
+class cube_cmd : public cmd {
+    unsigned m_depth;
+public:
+    cube_cmd():
+        cmd("cube"),
+        m_depth(0) {
+    }
+    virtual char const * get_usage() const { return "<depth>"; }
+    virtual char const * get_descr(cmd_context & ctx) const { return "retrieve a cube of at most <depth> literals that splits the search space, asserting the negation of each cube enumerates a partition of the problem"; }
+    virtual unsigned get_arity() const { return 1; }
+    virtual cmd_arg_kind next_arg_kind(cmd_context & ctx) const { return CPK_UINT; }
+    virtual void set_next_arg(cmd_context & ctx, unsigned val) { m_depth = val; }
+    virtual void execute(cmd_context & ctx) {
+        expr_ref c = ctx.cube(m_depth);
+        if (c) {
+            ctx.display(ctx.regular_stream(), c);
+            ctx.regular_stream() << std::endl;
+        }
+    }
+    virtual void prepare(cmd_context & ctx) { m_depth = 0; }
+};
+
 // provides "help" for builtin cmds
 class builtin_cmd : public cmd {
     char const * m_usage;
@@ -766,6 +829,8 @@ void install_basic_cmds(cmd_context & ctx) {
     ctx.insert(alloc(get_assertions_cmd));
     ctx.insert(alloc(get_proof_cmd));
     ctx.insert(alloc(get_unsat_core_cmd));
+    ctx.insert(alloc(get_consequences_cmd));
+    ctx.insert(alloc(cube_cmd));
     ctx.insert(alloc(set_option_cmd));
     ctx.insert(alloc(get_option_cmd));
     ctx.insert(alloc(get_info_cmd));
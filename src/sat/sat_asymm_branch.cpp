@@ -35,13 +35,19 @@ namespace sat {
         bool operator()(clause * c1, clause * c2) const { return c1->size() > c2->size(); }
     };
 
+    struct clause_glue_lt {
+        bool operator()(clause * c1, clause * c2) const { return c1->glue() < c2->glue(); }
+    };
+
     struct asymm_branch::report {
         asymm_branch & m_asymm_branch;
         stopwatch      m_watch;
         unsigned       m_elim_literals;
+        unsigned       m_elim_learned_literals;
         report(asymm_branch & a):
             m_asymm_branch(a),
-            m_elim_literals(a.m_elim_literals) {
+            m_elim_literals(a.m_elim_literals),
+            m_elim_learned_literals(a.m_elim_learned_literals) {
             m_watch.start();
         }
         
@@ -50,6 +56,8 @@ namespace sat {
             IF_VERBOSE(SAT_VB_LVL, 
                        verbose_stream() << " (sat-asymm-branch :elim-literals "
                        << (m_asymm_branch.m_elim_literals - m_elim_literals)
+                       << " :elim-learned-literals "
+                       << (m_asymm_branch.m_elim_learned_literals - m_elim_learned_literals)
                        << " :cost " << m_asymm_branch.m_counter
                        << mem_stat()
                        << " :time " << std::fixed << std::setprecision(2) << m_watch.get_seconds() << ")\n";);
@@ -72,10 +80,29 @@ namespace sat {
         int limit  = -static_cast<int>(m_asymm_branch_limit);
         std::stable_sort(s.m_clauses.begin(), s.m_clauses.end(), clause_size_lt());
         m_counter -= s.m_clauses.size();
+        process(s.m_clauses, false, limit);
+        if (m_asymm_branch_learned && !s.inconsistent()) {
+            // learned clauses get at most a tenth of the budget.
+            limit = std::max(limit, m_counter - static_cast<int>(m_asymm_branch_limit / 10));
+            std::stable_sort(s.m_learned.begin(), s.m_learned.end(), clause_glue_lt());
+            m_counter -= s.m_learned.size();
+            process(s.m_learned, true, limit);
+        }
+        m_counter = -m_counter;
+        s.m_phase = saved_phase;
+        CASSERT("asymm_branch", s.check_invariant());
+    }
+
+    /**
+       \brief Apply asymmetric branching to the given clauses, and remove the clauses that were
+       deleted or replaced by smaller ones from the vector. Only learned clauses that belong
+       to the core and tier2 tiers are processed, and each of them only once.
+    */
+    void asymm_branch::process(clause_vector & clauses, bool learned, int limit) {
         SASSERT(s.m_qhead == s.m_trail.size());
-        clause_vector::iterator it  = s.m_clauses.begin();
+        clause_vector::iterator it  = clauses.begin();
         clause_vector::iterator it2 = it;
-        clause_vector::iterator end = s.m_clauses.end();
+        clause_vector::iterator end = clauses.end();
         try {
             for (; it != end; ++it) {
                 if (s.inconsistent()) {
@@ -85,34 +112,33 @@ namespace sat {
                     break;
                 }
                 SASSERT(s.m_qhead == s.m_trail.size());
-                if (m_counter < limit || s.inconsistent()) {
+                clause & c = *(*it);
+                if (m_counter < limit || (learned && (c.frozen() || c.vivified() || c.glue() > s.m_config.m_gc_tier2_lbd))) {
                     *it2 = *it;
                     ++it2;
                     continue;
                 }
                 s.checkpoint();
-                clause & c = *(*it);
                 m_counter -= c.size();
                 if (!process(c))
                     continue; // clause was removed
+                if (learned)
+                    c.mark_vivified();
                 *it2 = *it;
                 // throw exception to test bug fix: if (it2 != it) throw solver_exception("trigger bug");
                 ++it2;
             }
-            s.m_clauses.set_end(it2);
+            clauses.set_end(it2);
         }
         catch (solver_exception & ex) {
-            // put m_clauses in a consistent state...
+            // put clauses in a consistent state...
             for (; it != end; ++it, ++it2) {
                 *it2 = *it;
             }
-            s.m_clauses.set_end(it2);
+            clauses.set_end(it2);
             m_counter = -m_counter;
             throw ex;
         }
-        m_counter = -m_counter;
-        s.m_phase = saved_phase;
-        CASSERT("asymm_branch", s.check_invariant());
     }
 
     bool asymm_branch::process(clause & c) {
@@ -134,72 +160,70 @@ namespace sat {
                 return false;
             }
         }
-        // try asymmetric branching
+        // try asymmetric branching (vivification):
+        // literals that are implied to be false by the negation of the previous ones are removed,
+        // and the clause is cut at the first literal implied to be true or after a conflict.
         // clause must not be used for propagation
         s.dettach_clause(c);
         s.push();
-        for (i = 0; i < sz - 1; i++) {
+        m_new_lits.reset();
+        for (i = 0; i < sz && !s.inconsistent(); i++) {
             literal l = c[i];
-            SASSERT(!s.inconsistent());
+            lbool val = s.value(l);
+            if (val == l_false)
+                continue;
+            m_new_lits.push_back(l);
+            if (val == l_true || i + 1 == sz)
+                break;
             TRACE("asymm_branch_detail", tout << "assigning: " << ~l << "\n";);
             s.assign(~l, justification());
             s.propagate_core(false); // must not use propagate(), since check_missed_propagation may fail for c
-            if (s.inconsistent())
-                break;
         }
         s.pop(1);
         SASSERT(!s.inconsistent());
         SASSERT(s.scope_lvl() == 0);
         SASSERT(trail_sz == s.m_trail.size());
         SASSERT(s.m_qhead == s.m_trail.size());
-        if (i == sz - 1) {
+        unsigned new_sz = m_new_lits.size();
+        if (new_sz == sz) {
             // clause size can't be reduced.
             s.attach_clause(c);
             return true;
         }
-        // clause can be reduced 
-        unsigned new_sz = i+1;
-        SASSERT(new_sz >= 1);
-        SASSERT(new_sz < sz);
-        TRACE("asymm_branch", tout << c << "\nnew_size: " << new_sz << "\n";
-              for (unsigned i = 0; i < c.size(); i++) tout << static_cast<int>(s.value(c[i])) << " "; tout << "\n";);
-        // cleanup reduced clause
-        unsigned j = 0;
-        for (i = 0; i < new_sz; i++) {
-            literal l = c[i];
-            switch (s.value(l)) {
-            case l_undef:
-                c[j] = l;
-                j++;
-                break;
-            case l_false:
-                break;
-            case l_true:
-                UNREACHABLE();
-                break;
-            }
-        }
-        new_sz = j;
-        m_elim_literals += sz - new_sz;
+        // clause can be reduced
+        TRACE("asymm_branch", tout << c << "\nnew clause: " << m_new_lits << "\n";);
+        if (c.is_learned())
+            m_elim_learned_literals += sz - new_sz;
+        else
+            m_elim_literals += sz - new_sz;
         switch(new_sz) {
         case 0:
             s.set_conflict(justification());
             return false;
         case 1:
-            TRACE("asymm_branch", tout << "produced unit clause: " << c[0] << "\n";);
-            s.assign(c[0], justification());
+            TRACE("asymm_branch", tout << "produced unit clause: " << m_new_lits[0] << "\n";);
+            s.assign(m_new_lits[0], justification());
             s.del_clause(c);
             s.propagate_core(false); 
             SASSERT(s.inconsistent() || s.m_qhead == s.m_trail.size());
             return false; // check_missed_propagation() may fail, since m_clauses is not in a consistent state.
         case 2:
-            SASSERT(s.value(c[0]) == l_undef && s.value(c[1]) == l_undef);
-            s.mk_bin_clause(c[0], c[1], false);
+            SASSERT(s.value(m_new_lits[0]) == l_undef && s.value(m_new_lits[1]) == l_undef);
+            if (s.m_config.m_drat) s.m_drat.add(m_new_lits[0], m_new_lits[1]);
+            s.mk_bin_clause(m_new_lits[0], m_new_lits[1], c.is_learned());
             s.del_clause(c);
             SASSERT(s.m_qhead == s.m_trail.size());
             return false;
         default:
+            if (s.m_config.m_drat) {
+                s.m_drat.add(m_new_lits);
+                s.m_drat.del(c);
+            }
+            for (i = 0; i < new_sz; i++)
+                c[i] = m_new_lits[i];
             c.shrink(new_sz);
+            if (c.glue() > new_sz)
+                c.set_glue(new_sz);
             s.attach_clause(c);
             SASSERT(s.m_qhead == s.m_trail.size());
             return true;
@@ -211,6 +235,7 @@ namespace sat {
         m_asymm_branch        = p.asymm_branch();
         m_asymm_branch_rounds = p.asymm_branch_rounds();
         m_asymm_branch_limit  = p.asymm_branch_limit();
+        m_asymm_branch_learned = p.asymm_branch_learned();
         if (m_asymm_branch_limit > INT_MAX)
             m_asymm_branch_limit = INT_MAX;
     }
@@ -221,10 +246,12 @@ namespace sat {
     
     void asymm_branch::collect_statistics(statistics & st) const {
         st.update("elim literals", m_elim_literals);
+        st.update("elim learned literals", m_elim_learned_literals);
     }
 
     void asymm_branch::reset_statistics() {
         m_elim_literals = 0;
+        m_elim_learned_literals = 0;
     }
 
 };
@@ -36,10 +36,15 @@ namespace sat {
         bool                   m_asymm_branch;
         unsigned               m_asymm_branch_rounds;
         unsigned               m_asymm_branch_limit;
+        bool                   m_asymm_branch_learned;
 
         // stats
         unsigned m_elim_literals;
+        unsigned m_elim_learned_literals;
 
+        literal_vector         m_new_lits;
+
+        void process(clause_vector & clauses, bool learned, int limit);
         bool process(clause & c);
     public:
         asymm_branch(solver & s, params_ref const & p);
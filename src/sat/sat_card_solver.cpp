@@ -0,0 +1,401 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    sat_card_solver.cpp
+
+Abstract:
+
+    Cardinality and pseudo-Boolean constraints.
+
+Revision History:
+
+--*/
+#include"sat_card_solver.h"
+#include"sat_solver.h"
+
+namespace sat {
+
+    struct wliteral_var_lt {
+        bool operator()(std::pair<uint64, literal> const & w1, std::pair<uint64, literal> const & w2) const {
+            return w1.second.var() < w2.second.var();
+        }
+    };
+
+    struct wliteral_coeff_gt {
+        bool operator()(std::pair<uint64, literal> const & w1, std::pair<uint64, literal> const & w2) const {
+            return w1.first > w2.first;
+        }
+    };
+
+    card_solver::card_solver(solver & s):
+        s(s) {
+    }
+
+    void card_solver::add_at_least(literal lit, unsigned n, literal const * lits, unsigned k) {
+        unsigned_vector coeffs;
+        coeffs.resize(n, 1);
+        add_pb_ge(lit, n, lits, coeffs.c_ptr(), k);
+    }
+
+    void card_solver::add_pb_ge(literal lit, unsigned n, literal const * lits, unsigned const * coeffs, unsigned k) {
+        s.pop_to_base_level();
+        if (s.inconsistent())
+            return;
+        TRACE("sat_card", tout << lit << " <=> ";
+              for (unsigned i = 0; i < n; ++i) tout << coeffs[i] << "*" << lits[i] << " ";
+              tout << ">= " << k << "\n";);
+        m_wlits.reset();
+        for (unsigned i = 0; i < n; ++i)
+            m_wlits.push_back(wliteral(coeffs[i], lits[i]));
+        if (lit == null_literal) {
+            add_constraint(m_wlits, k);
+            return;
+        }
+        // lit => c_1*l_1 + ... + c_n*l_n >= k
+        m_wlits.push_back(wliteral(k, ~lit));
+        add_constraint(m_wlits, k);
+        if (s.inconsistent())
+            return;
+        // ~lit => c_1*~l_1 + ... + c_n*~l_n >= c_1 + ... + c_n - k + 1
+        uint64 sum = 0;
+        m_wlits.reset();
+        for (unsigned i = 0; i < n; ++i) {
+            m_wlits.push_back(wliteral(coeffs[i], ~lits[i]));
+            sum += coeffs[i];
+        }
+        if (sum + 1 <= k) {
+            // ~lit is implied by the first constraint.
+            return;
+        }
+        m_wlits.push_back(wliteral(sum + 1 - k, lit));
+        add_constraint(m_wlits, sum + 1 - k);
+    }
+
+    /**
+       \brief Normalize and add the constraint  sum wlits >= k.
+       \pre base level.
+    */
+    void card_solver::add_constraint(svector<wliteral> & wlits, uint64 k0) {
+        SASSERT(s.scope_lvl() == 0);
+        // the constraint is relative to the current user scopes:
+        // it is satisfied when one of the scope literals is true.
+        for (unsigned i = 0; i < s.m_user_scope_literals.size(); ++i)
+            wlits.push_back(wliteral(k0, s.m_user_scope_literals[i]));
+        // simplify with the base level assignment and merge the occurrences of a variable.
+        int64 k = k0;
+        std::sort(wlits.begin(), wlits.end(), wliteral_var_lt());
+        unsigned j = 0;
+        for (unsigned i = 0; i < wlits.size(); ++i) {
+            uint64 c  = wlits[i].first;
+            literal l = wlits[i].second;
+            SASSERT(!s.was_eliminated(l.var()));
+            if (c == 0 || s.value(l) == l_false)
+                continue;
+            if (s.value(l) == l_true) {
+                k -= c;
+                continue;
+            }
+            if (j > 0 && wlits[j - 1].second.var() == l.var()) {
+                wliteral & w = wlits[j - 1];
+                if (w.second == l) {
+                    w.first += c;
+                    continue;
+                }
+                // c1*l + c2*~l = min(c1, c2) + |c1 - c2|*l', where l' is the literal with the larger coefficient.
+                k -= std::min(w.first, c);
+                if (w.first < c) {
+                    w.first  = c - w.first;
+                    w.second = l;
+                }
+                else {
+                    w.first -= c;
+                }
+                if (w.first == 0)
+                    --j;
+                continue;
+            }
+            wlits[j++] = wliteral(c, l);
+        }
+        wlits.shrink(j);
+        if (k <= 0)
+            return;
+        // saturate the coefficients.
+        uint64 sum = 0;
+        bool is_clause = true, same_coeffs = true;
+        for (unsigned i = 0; i < wlits.size(); ++i) {
+            uint64 & c = wlits[i].first;
+            c = std::min(c, static_cast<uint64>(k));
+            sum += c;
+            is_clause   &= c == static_cast<uint64>(k);
+            same_coeffs &= c == wlits[0].first;
+        }
+        if (sum < static_cast<uint64>(k)) {
+            TRACE("sat_card", tout << "infeasible constraint\n";);
+            s.set_conflict(justification());
+            return;
+        }
+        if (is_clause) {
+            literal_vector lits;
+            for (unsigned i = 0; i < wlits.size(); ++i)
+                lits.push_back(wlits[i].second);
+            s.mk_clause_core(lits.size(), lits.c_ptr(), false);
+            return;
+        }
+        if (same_coeffs) {
+            // c*l_1 + ... + c*l_n >= k  iff  l_1 + ... + l_n >= ceil(k/c)
+            uint64 c = wlits[0].first;
+            k = (k + c - 1) / c;
+            for (unsigned i = 0; i < wlits.size(); ++i)
+                wlits[i].first = 1;
+            m_stats.m_num_cards++;
+        }
+        else {
+            std::sort(wlits.begin(), wlits.end(), wliteral_coeff_gt());
+            m_stats.m_num_pbs++;
+        }
+        unsigned idx = m_constraints.size();
+        m_constraints.push_back(constraint(k, m_lits.size(), wlits.size()));
+        for (unsigned i = 0; i < wlits.size(); ++i) {
+            literal l = wlits[i].second;
+            m_lits.push_back(l);
+            m_coeffs.push_back(wlits[i].first);
+            m_occ2constraint.push_back(idx);
+            // the variables of the constraints must not be eliminated.
+            s.m_external[l.var()] = true;
+        }
+        watch(idx);
+        init_constraint(idx);
+    }
+
+    void card_solver::watch(unsigned idx) {
+        constraint const & c = m_constraints[idx];
+        for (unsigned i = c.m_start; i < c.m_start + c.m_size; ++i)
+            s.get_wlist(~m_lits[i]).push_back(watched(i));
+    }
+
+    void card_solver::unwatch_all() {
+        for (unsigned i = 0; i < m_lits.size(); ++i) {
+            watch_list & wlist = s.get_wlist(~m_lits[i]);
+            watch_list::iterator it  = wlist.begin();
+            watch_list::iterator it2 = it;
+            watch_list::iterator end = wlist.end();
+            for (; it != end; ++it) {
+                if (!it->is_ext_constraint()) {
+                    *it2 = *it;
+                    ++it2;
+                }
+            }
+            wlist.set_end(it2);
+        }
+    }
+
+    /**
+       \brief Compute the slack of the constraint from the assignment, and propagate it.
+       \pre base level, and the assigned literals that are not propagated yet are marked.
+    */
+    void card_solver::init_constraint(unsigned idx) {
+        SASSERT(s.scope_lvl() == 0);
+        constraint & c = m_constraints[idx];
+        int64 slack = -static_cast<int64>(c.m_k);
+        for (unsigned i = c.m_start; i < c.m_start + c.m_size; ++i) {
+            literal l = m_lits[i];
+            // the false literals that are not propagated yet are counted when they are propagated.
+            if (s.value(l) != l_false || s.is_marked(l.var()))
+                slack += m_coeffs[i];
+        }
+        c.m_slack = slack;
+        if (slack < static_cast<int64>(m_coeffs[c.m_start]))
+            propagate(idx);
+    }
+
+    /**
+       \brief Save the negations of the false literals of the constraint,
+       and store in slack the sum of the coefficients of the other literals minus k.
+    */
+    unsigned card_solver::mk_reason(unsigned idx, int64 & slack) {
+        constraint const & c = m_constraints[idx];
+        unsigned r = m_reasons.size();
+        m_reasons.push_back(m_antecedents.size());
+        slack = -static_cast<int64>(c.m_k);
+        for (unsigned i = c.m_start; i < c.m_start + c.m_size; ++i) {
+            literal l = m_lits[i];
+            if (s.value(l) == l_false)
+                m_antecedents.push_back(~l);
+            else
+                slack += m_coeffs[i];
+        }
+        return r;
+    }
+
+    /**
+       \brief Propagate the literals whose coefficient exceeds the slack, or report a conflict.
+       The slack is recomputed from the assignment, since the counter does not
+       account for the false literals that are not propagated yet.
+    */
+    void card_solver::propagate(unsigned idx) {
+        constraint const & c = m_constraints[idx];
+        int64 slack;
+        unsigned r = mk_reason(idx, slack);
+        // at base level the inferences do not need a justification.
+        justification js = m_scopes.empty() ? justification() : justification::mk_ext_justification(r);
+        bool used = false;
+        if (slack < 0) {
+            TRACE("sat_card", tout << "conflict\n"; display(tout););
+            m_stats.m_num_conflicts++;
+            s.set_conflict(js);
+            used = true;
+        }
+        else {
+            for (unsigned i = c.m_start; i < c.m_start + c.m_size && static_cast<int64>(m_coeffs[i]) > slack; ++i) {
+                literal l = m_lits[i];
+                if (s.value(l) == l_undef) {
+                    TRACE("sat_card", tout << "propagate " << l << "\n";);
+                    m_stats.m_num_propagations++;
+                    s.assign(l, js);
+                    used = true;
+                }
+            }
+        }
+        if (!used || m_scopes.empty()) {
+            m_antecedents.shrink(m_reasons[r]);
+            m_reasons.pop_back();
+        }
+    }
+
+    void card_solver::propagate(literal l, ext_constraint_idx idx, bool & keep) {
+        keep = true;
+        SASSERT(m_lits[idx] == ~l);
+        unsigned c_idx = m_occ2constraint[idx];
+        constraint & c = m_constraints[c_idx];
+        c.m_slack -= m_coeffs[idx];
+        if (!m_scopes.empty())
+            m_undo.push_back(idx);
+        // the coefficients are ordered, so only the first one has to be compared with the slack.
+        if (c.m_slack < static_cast<int64>(m_coeffs[c.m_start]))
+            propagate(c_idx);
+    }
+
+    void card_solver::get_antecedents(literal l, ext_justification_idx idx, literal_vector & r) {
+        unsigned end = idx + 1 < m_reasons.size() ? m_reasons[idx + 1] : m_antecedents.size();
+        for (unsigned i = m_reasons[idx]; i < end; ++i)
+            r.push_back(m_antecedents[i]);
+    }
+
+    check_result card_solver::check() {
+        // the counters can be off when only part of the current level is retracted,
+        // so the constraints are checked again on the complete assignment.
+        for (unsigned idx = 0; idx < m_constraints.size() && !s.inconsistent(); ++idx) {
+            constraint const & c = m_constraints[idx];
+            uint64 sum = 0;
+            for (unsigned i = c.m_start; i < c.m_start + c.m_size; ++i) {
+                if (s.value(m_lits[i]) == l_true)
+                    sum += m_coeffs[i];
+            }
+            if (sum < c.m_k)
+                propagate(idx);
+        }
+        return s.inconsistent() ? CR_CONTINUE : CR_DONE;
+    }
+
+    void card_solver::push() {
+        scope sc;
+        sc.m_undo_lim    = m_undo.size();
+        sc.m_reasons_lim = m_reasons.size();
+        m_scopes.push_back(sc);
+    }
+
+    void card_solver::pop(unsigned n) {
+        SASSERT(n <= m_scopes.size());
+        scope const & sc = m_scopes[m_scopes.size() - n];
+        for (unsigned i = m_undo.size(); i-- > sc.m_undo_lim; ) {
+            unsigned occ = m_undo[i];
+            m_constraints[m_occ2constraint[occ]].m_slack += m_coeffs[occ];
+        }
+        m_undo.shrink(sc.m_undo_lim);
+        if (sc.m_reasons_lim < m_reasons.size()) {
+            m_antecedents.shrink(m_reasons[sc.m_reasons_lim]);
+            m_reasons.shrink(sc.m_reasons_lim);
+        }
+        m_scopes.shrink(m_scopes.size() - n);
+    }
+
+    void card_solver::gc_lit(literal lit) {
+        SASSERT(s.scope_lvl() == 0);
+        SASSERT(m_undo.empty() && m_reasons.empty());
+        unwatch_all();
+        literal_vector  lits;
+        svector<uint64> coeffs;
+        unsigned j = 0;
+        for (unsigned idx = 0; idx < m_constraints.size(); ++idx) {
+            constraint c = m_constraints[idx];
+            bool del = false;
+            for (unsigned i = c.m_start; !del && i < c.m_start + c.m_size; ++i)
+                del = m_lits[i] == lit;
+            if (del)
+                continue;
+            for (unsigned i = c.m_start; i < c.m_start + c.m_size; ++i) {
+                lits.push_back(m_lits[i]);
+                coeffs.push_back(m_coeffs[i]);
+            }
+            c.m_start = j == 0 ? 0 : m_constraints[j - 1].m_start + m_constraints[j - 1].m_size;
+            m_constraints[j++] = c;
+        }
+        m_constraints.shrink(j);
+        m_lits.swap(lits);
+        m_coeffs.swap(coeffs);
+        m_occ2constraint.reset();
+        for (unsigned idx = 0; idx < m_constraints.size(); ++idx)
+            m_occ2constraint.resize(m_occ2constraint.size() + m_constraints[idx].m_size, idx);
+        for (unsigned idx = 0; idx < m_constraints.size(); ++idx)
+            watch(idx);
+        // the base level assignment may have been retracted, so the slack is computed again.
+        // the assigned literals that are not propagated yet are marked, see init_constraint.
+        unsigned qhead = s.m_qhead, sz = qhead;
+        for (unsigned idx = 0; idx < m_constraints.size() && !s.inconsistent(); ++idx) {
+            for (; sz < s.m_trail.size(); ++sz)
+                s.mark(s.m_trail[sz].var());
+            init_constraint(idx);
+        }
+        for (unsigned i = qhead; i < sz; ++i)
+            s.reset_mark(s.m_trail[i].var());
+    }
+
+    bool card_solver::check_model(model const & m) const {
+        bool ok = true;
+        for (unsigned idx = 0; idx < m_constraints.size(); ++idx) {
+            constraint const & c = m_constraints[idx];
+            uint64 sum = 0;
+            for (unsigned i = c.m_start; i < c.m_start + c.m_size; ++i) {
+                if (value_at(m_lits[i], m) == l_true)
+                    sum += m_coeffs[i];
+            }
+            if (sum < c.m_k) {
+                TRACE("sat", tout << "failed constraint " << idx << "\n"; display(tout););
+                ok = false;
+            }
+        }
+        return ok;
+    }
+
+    void card_solver::collect_statistics(statistics & st) const {
+        st.update("cardinality constraints", m_stats.m_num_cards);
+        st.update("pb constraints", m_stats.m_num_pbs);
+        st.update("pb propagations", m_stats.m_num_propagations);
+        st.update("pb conflicts", m_stats.m_num_conflicts);
+    }
+
+    void card_solver::display(std::ostream & out) const {
+        for (unsigned idx = 0; idx < m_constraints.size(); ++idx) {
+            constraint const & c = m_constraints[idx];
+            for (unsigned i = c.m_start; i < c.m_start + c.m_size; ++i) {
+                if (m_coeffs[i] != 1)
+                    out << m_coeffs[i] << "*";
+                out << m_lits[i] << " ";
+            }
+            out << ">= " << c.m_k << " slack: " << c.m_slack << "\n";
+        }
+    }
+
+};
@@ -0,0 +1,134 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    sat_card_solver.h
+
+Abstract:
+
+    Cardinality and pseudo-Boolean constraints.
+
+    Constraints are normalized to the form
+
+        c_1*l_1 + ... + c_n*l_n >= k
+
+    where the coefficients are positive and at most k.
+    Cardinality constraints are the ones where all coefficients are 1.
+
+    Propagation is counter based: every literal of a constraint is watched,
+    and the constraint maintains its slack, that is, the sum of the
+    coefficients of the literals that are not false minus k.
+    A literal l_i is propagated when c_i exceeds the slack, and the
+    constraint is conflicting when the slack is negative.
+
+    The antecedents of propagations are the false literals of the
+    constraint when the propagation takes place. They are saved,
+    since they cannot be recovered after further assignments.
+
+Revision History:
+
+--*/
+#ifndef SAT_CARD_SOLVER_H_
+#define SAT_CARD_SOLVER_H_
+
+#include"sat_extension.h"
+#include"statistics.h"
+
+namespace sat {
+
+    class card_solver : public extension {
+        struct stats {
+            unsigned m_num_cards;
+            unsigned m_num_pbs;
+            unsigned m_num_propagations;
+            unsigned m_num_conflicts;
+            stats() { reset(); }
+            void reset() { memset(this, 0, sizeof(*this)); }
+        };
+
+        struct constraint {
+            uint64   m_k;
+            unsigned m_start;   // first occurrence
+            unsigned m_size;
+            int64    m_slack;   // sum of the coefficients of the literals that are not false, minus k
+            constraint(uint64 k, unsigned start, unsigned size):
+                m_k(k), m_start(start), m_size(size), m_slack(0) {}
+        };
+
+        typedef std::pair<uint64, literal> wliteral;
+
+        struct scope {
+            unsigned m_undo_lim;
+            unsigned m_reasons_lim;
+        };
+
+        solver &                s;
+        stats                   m_stats;
+        svector<constraint>     m_constraints;
+        // the occurrences of the literals in the constraints, ordered by decreasing coefficient.
+        // the watches of the literals refer to their occurrence.
+        literal_vector          m_lits;
+        svector<uint64>         m_coeffs;
+        unsigned_vector         m_occ2constraint;
+        unsigned_vector         m_undo;        // occurrences whose literal was assigned to false
+        literal_vector          m_antecedents;
+        unsigned_vector         m_reasons;     // reason -> first antecedent
+        svector<scope>          m_scopes;
+        svector<wliteral>       m_wlits;
+
+        void add_constraint(svector<wliteral> & wlits, uint64 k);
+        void watch(unsigned idx);
+        void unwatch_all();
+        void init_constraint(unsigned idx);
+        void propagate(unsigned idx);
+        unsigned mk_reason(unsigned idx, int64 & slack);
+
+    public:
+        card_solver(solver & s);
+        virtual ~card_solver() {}
+
+        virtual void propagate(literal l, ext_constraint_idx idx, bool & keep);
+        virtual void get_antecedents(literal l, ext_justification_idx idx, literal_vector & r);
+        virtual void asserted(literal l) {}
+        virtual check_result check();
+        virtual void push();
+        virtual void pop(unsigned n);
+        virtual void simplify() {}
+        virtual void clauses_modifed() {}
+        virtual lbool get_phase(bool_var v) { return l_undef; }
+
+        /**
+           \brief Add the constraint  lit <=> coeffs[0]*lits[0] + ... + coeffs[n-1]*lits[n-1] >= k.
+           If lit is null_literal, then the constraint is added without the equivalence.
+           The constraint is relative to the current user scope, like clauses.
+        */
+        void add_pb_ge(literal lit, unsigned n, literal const * lits, unsigned const * coeffs, unsigned k);
+
+        /**
+           \brief Add the constraint  lit <=> lits[0] + ... + lits[n-1] >= k.
+        */
+        void add_at_least(literal lit, unsigned n, literal const * lits, unsigned k);
+
+        /**
+           \brief Remove the constraints that contain the scope literal lit.
+           The slack of the remaining constraints is recomputed,
+           since base level assignments are retracted when a user scope is popped.
+        */
+        void gc_lit(literal lit);
+
+        unsigned num_constraints() const { return m_constraints.size(); }
+        uint64 get_k(unsigned idx) const { return m_constraints[idx].m_k; }
+        unsigned get_size(unsigned idx) const { return m_constraints[idx].m_size; }
+        literal get_lit(unsigned idx, unsigned i) const { return m_lits[m_constraints[idx].m_start + i]; }
+        uint64 get_coeff(unsigned idx, unsigned i) const { return m_coeffs[m_constraints[idx].m_start + i]; }
+
+        bool check_model(model const & m) const;
+        void collect_statistics(statistics & st) const;
+        void reset_statistics() { m_stats.reset(); }
+        void display(std::ostream & out) const;
+    };
+
+};
+
+#endif
@@ -17,6 +17,7 @@ Revision History:
 
 --*/
 #include<memory.h>
+#include<algorithm>
 #include"sat_clause.h"
 #include"z3_exception.h"
 #include"trace.h"
@@ -25,6 +26,7 @@ namespace sat {
 
     clause::clause(unsigned id, unsigned sz, literal const * lits, bool learned):
         m_id(id),
+        m_offset(0),
         m_size(sz),
         m_capacity(sz),
         m_removed(false),
@@ -32,6 +34,8 @@ namespace sat {
         m_used(false),
         m_frozen(false),
         m_reinit_stack(false),
+        m_moved(false),
+        m_vivified(false),
         m_inact_rounds(0) {
         memcpy(m_lits, lits, sizeof(literal) * sz);
         mark_strengthened();
@@ -120,57 +124,63 @@ namespace sat {
         }
     }
 
+    void clause_allocator::arena::reset() {
+        for (unsigned i = 0; i < m_pages.size(); ++i) {
+            dealloc_svect(m_pages[i]);
+        }
+        m_pages.reset();
+        m_sizes.reset();
+        m_capacities.reset();
+    }
+
     clause_allocator::clause_allocator():
-        m_allocator("clause-allocator") {
-#ifdef _AMD64_
-        m_num_segments = 0;
-#endif
-    }
-
-    clause * clause_allocator::get_clause(clause_offset cls_off) const {
-#ifdef _AMD64_
-        return reinterpret_cast<clause *>(m_segments[cls_off & c_aligment_mask] + (static_cast<size_t>(cls_off) & ~c_aligment_mask));
-#else
-        return reinterpret_cast<clause *>(cls_off);
-#endif
-    }
-
-#ifdef _AMD64_
-    unsigned clause_allocator::get_segment(size_t ptr) {
-        SASSERT((ptr & c_aligment_mask) == 0);
-        ptr &= ~0xFFFFFFFFull; // Keep only high part
-        unsigned i = 0;
-        for (i = 0; i < m_num_segments; ++i)
-            if (m_segments[i] == ptr)
-                return i;
-        i = m_num_segments;
-        m_num_segments++;
-        SASSERT(m_num_segments <= c_max_segments);
-        if (i >= c_max_segments)
-            throw default_exception("segment out of range");
-        m_segments[i] = ptr;
-        return i;
-    }
-#endif
-
-    clause_offset clause_allocator::get_offset(clause const * ptr) const {
-#ifdef _AMD64_
-        return static_cast<unsigned>(reinterpret_cast<size_t>(ptr)) + const_cast<clause_allocator*>(this)->get_segment(reinterpret_cast<size_t>(ptr));
-#else
-        return reinterpret_cast<size_t>(ptr);
-#endif
+        m_num_clauses(0),
+        m_num_relocated(0),
+        m_num_words(0),
+        m_num_wasted(0) {
+    }
+
+    clause_allocator::~clause_allocator() {
+        m_arena.reset();
+        m_old_arena.reset();
+    }
+
+    clause * clause_allocator::allocate(unsigned num_lits) {
+        unsigned num_words = get_num_words(num_lits);
+        svector<word*> & pages = m_arena.m_pages;
+        unsigned idx = pages.size();
+        if (idx > 0) {
+            unsigned pos = m_arena.m_sizes[idx-1];
+            // the position of a clause must be representable in c_pos_bits.
+            if (pos <= c_pos_mask && m_arena.m_capacities[idx-1] - pos >= num_words) {
+                m_arena.m_sizes[idx-1] += num_words;
+                m_num_words += num_words;
+                clause * cls = reinterpret_cast<clause *>(pages[idx-1] + pos);
+                cls->m_offset = ((idx - 1) << c_pos_bits) + pos;
+                return cls;
+            }
+        }
+        if (idx >= c_max_pages)
+            throw default_exception("clause allocator out of range");
+        unsigned capacity = idx == 0 ? c_min_page_size : std::min(2 * m_arena.m_capacities[idx-1], c_max_page_size);
+        // clauses larger than a page get a page of their own.
+        capacity = std::max(capacity, num_words);
+        pages.push_back(alloc_svect(word, capacity));
+        m_arena.m_sizes.push_back(num_words);
+        m_arena.m_capacities.push_back(capacity);
+        m_num_words += num_words;
+        clause * cls = reinterpret_cast<clause *>(pages[idx]);
+        cls->m_offset = idx << c_pos_bits;
+        return cls;
     }
     
     clause * clause_allocator::mk_clause(unsigned num_lits, literal const * lits, bool learned) {
-        size_t size = clause::get_obj_size(num_lits);
-#ifdef _AMD64_
-        size_t slot = size >> c_cls_alignment;
-        if ((size & c_aligment_mask) != 0)
-            slot++;
-        size = slot << c_cls_alignment;
-#endif
-        void * mem = m_allocator.allocate(size);
+        SASSERT(m_old_arena.m_pages.empty());
+        void * mem = allocate(num_lits);
+        clause_offset off = static_cast<clause *>(mem)->m_offset;
         clause * cls = new (mem) clause(m_id_gen.mk(), num_lits, lits, learned);
+        cls->m_offset = off;
+        m_num_clauses++;
         TRACE("sat", tout << "alloc: " << cls->id() << " " << cls << " " << *cls << " " << (learned?"l":"a") << "\n";);
         SASSERT(!learned || cls->is_learned());
         return cls;
@@ -178,16 +188,63 @@ namespace sat {
 
     void clause_allocator::del_clause(clause * cls) {
         TRACE("sat", tout << "delete: " << cls->id() << " " << cls << " " << *cls << "\n";);
+        SASSERT(m_old_arena.m_pages.empty());
         m_id_gen.recycle(cls->id());
-        size_t size = clause::get_obj_size(cls->m_capacity);
-#ifdef _AMD64_
-        size_t slot = size >> c_cls_alignment;
-        if ((size & c_aligment_mask) != 0)
-            slot++;
-        size = slot << c_cls_alignment;
-#endif
+        m_num_wasted += get_num_words(cls->m_capacity);
         cls->~clause();
-        m_allocator.deallocate(size, cls);
+        SASSERT(m_num_clauses > 0);
+        m_num_clauses--;
+        if (m_num_clauses == 0) {
+            // nothing refers to the arena anymore, reuse its first page.
+            for (unsigned i = 1; i < m_arena.m_pages.size(); ++i) {
+                dealloc_svect(m_arena.m_pages[i]);
+            }
+            if (!m_arena.m_pages.empty()) {
+                m_arena.m_pages.shrink(1);
+                m_arena.m_capacities.shrink(1);
+                m_arena.m_sizes.shrink(1);
+                m_arena.m_sizes[0] = 0;
+            }
+            m_num_words  = 0;
+            m_num_wasted = 0;
+        }
+    }
+
+    void clause_allocator::begin_relocation() {
+        SASSERT(m_old_arena.m_pages.empty());
+        m_old_arena.m_pages.swap(m_arena.m_pages);
+        m_old_arena.m_sizes.swap(m_arena.m_sizes);
+        m_old_arena.m_capacities.swap(m_arena.m_capacities);
+        m_num_relocated = 0;
+        m_num_words  = 0;
+        m_num_wasted = 0;
+    }
+
+    clause * clause_allocator::relocate(clause * cls) {
+        if (cls->m_moved) {
+            return get_clause(cls->m_offset);
+        }
+        unsigned sz = cls->m_size;
+        clause * r = allocate(sz);
+        clause_offset off = r->m_offset;
+        memcpy(r, cls, clause::get_obj_size(sz));
+        r->m_offset   = off;
+        r->m_capacity = sz;
+        cls->m_moved  = true;
+        cls->m_offset = off;
+        m_num_relocated++;
+        return r;
+    }
+
+    clause_offset clause_allocator::relocate(clause_offset old_off) {
+        clause * cls = reinterpret_cast<clause *>(m_old_arena.page(old_off) + (old_off & c_pos_mask));
+        return relocate(cls)->m_offset;
+    }
+
+    void clause_allocator::end_relocation() {
+        // clauses that were not relocated would be lost.
+        VERIFY(m_num_relocated == m_num_clauses);
+        m_old_arena.reset();
     }
 
     std::ostream & operator<<(std::ostream & out, clause const & c) {
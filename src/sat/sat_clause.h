@@ -20,7 +20,6 @@ Revision History:
 #define SAT_CLAUSE_H_
 
 #include"sat_types.h"
-#include"small_object_allocator.h"
 #include"id_gen.h"
 
 #ifdef _MSC_VER
@@ -36,6 +35,7 @@ namespace sat {
         friend class clause_allocator;
         friend class tmp_clause;
         unsigned           m_id;
+        clause_offset      m_offset;   // position in the clause allocator, or the new position after relocation
         unsigned           m_size;
         unsigned           m_capacity;
         var_approx_set     m_approx;
@@ -45,6 +45,8 @@ namespace sat {
         unsigned           m_used:1;
         unsigned           m_frozen:1;
         unsigned           m_reinit_stack:1;
+        unsigned           m_moved:1;
+        unsigned           m_vivified:1;
         unsigned           m_inact_rounds:8;
         unsigned           m_glue:8; 
         unsigned           m_psm:8;  // transient field used during gc
@@ -90,6 +92,9 @@ namespace sat {
         void set_psm(unsigned psm) { m_psm = psm > 255 ? 255 : psm; }
         unsigned psm() const { return m_psm; }
 
+        bool vivified() const { return m_vivified; }
+        void mark_vivified() { m_vivified = true; }
+
         bool on_reinit_stack() const { return m_reinit_stack; }
         void set_reinit_stack(bool f) { m_reinit_stack = f; }
     };
@@ -119,25 +124,67 @@ namespace sat {
     };
 
     /**
-       \brief Simple clause allocator that allows uint (32bit integers) to be used to reference clauses (even in 64bit machines).
+       \brief Clause allocator that allows uint (32bit integers) to be used to reference clauses (even in 64bit machines).
+
+       Clauses are stored contiguously in an arena made of a few large pages.
+       A clause offset encodes the page and the position (in words) of the clause in the page.
+       Memory of deleted clauses is only reclaimed when the clauses are relocated
+       to a fresh arena, which also allows the solver to place clauses in the order
+       in which they are traversed.
     */
     class clause_allocator {
-        small_object_allocator m_allocator;
+        typedef uint64 word;
+        static const unsigned  c_pos_bits      = 20;
+        static const unsigned  c_pos_mask      = (1u << c_pos_bits) - 1;
+        static const unsigned  c_max_pages     = 1u << (32 - c_pos_bits);
+        static const unsigned  c_min_page_size = 1u << 10;
+        static const unsigned  c_max_page_size = 1u << c_pos_bits;
+
+        struct arena {
+            svector<word*>  m_pages;
+            unsigned_vector m_sizes;       // number of words used in each page
+            unsigned_vector m_capacities;
+            word * page(clause_offset cls_off) const { return m_pages[cls_off >> c_pos_bits]; }
+            void reset();
+        };
+
+        arena                  m_arena;
+        arena                  m_old_arena;    // clauses that are being relocated
+        unsigned               m_num_clauses;
+        unsigned               m_num_relocated;
+        size_t                 m_num_words;
+        size_t                 m_num_wasted;   // words used by deleted clauses and removed literals
         id_gen                 m_id_gen;
-#ifdef _AMD64_
-        unsigned get_segment(size_t ptr);
-        static const unsigned  c_cls_alignment = 3; 
-        static const unsigned  c_max_segments  = 1 << c_cls_alignment;
-        static const size_t    c_aligment_mask = (1ull << c_cls_alignment) - 1ull;
-        unsigned               m_num_segments;
-        size_t                 m_segments[c_max_segments];
-#endif
+
+        static unsigned get_num_words(unsigned num_lits) {
+            return static_cast<unsigned>((clause::get_obj_size(num_lits) + sizeof(word) - 1) / sizeof(word));
+        }
+        clause * allocate(unsigned num_lits);
     public:
         clause_allocator();
-        clause *      get_clause(clause_offset cls_off) const;
-        clause_offset get_offset(clause const * ptr) const;
+        ~clause_allocator();
+        clause *      get_clause(clause_offset cls_off) const {
+            return reinterpret_cast<clause *>(m_arena.page(cls_off) + (cls_off & c_pos_mask));
+        }
+        clause_offset get_offset(clause const * ptr) const { SASSERT(!ptr->m_moved); return ptr->m_offset; }
         clause *      mk_clause(unsigned num_lits, literal const * lits, bool learned);
         void          del_clause(clause * cls);
+
+        /**
+           \brief Number of words that would be reclaimed by relocating the clauses.
+        */
+        size_t        num_wasted_words() const { return m_num_wasted; }
+        size_t        num_words() const { return m_num_words; }
+
+        /**
+           \brief Relocation: after begin_relocation, every live clause must be relocated,
+           either through a pointer or through its offset from before the relocation.
+           The memory used by the old clauses is released by end_relocation.
+        */
+        void          begin_relocation();
+        clause *      relocate(clause * cls);
+        clause_offset relocate(clause_offset old_off);
+        void          end_relocation();
     };
 
     /**
@@ -99,7 +99,8 @@ namespace sat {
                     m_elim_literals++;
                     break;
                 case l_undef:
-                    c[j] = c[i];
+                    // swap preserves the literals of c for logging its deletion in DRAT.
+                    std::swap(c[j], c[i]);
                     j++;
                     break;
                 }
@@ -135,10 +136,15 @@ namespace sat {
                     SASSERT(s.value(c[0]) == l_undef && s.value(c[1]) == l_undef);
                     if (new_sz == 2) {
                         TRACE("cleanup_bug", tout << "clause became binary: " << c[0] << " " << c[1] << "\n";);
+                        if (s.m_config.m_drat) s.m_drat.add(c[0], c[1]);
                         s.mk_bin_clause(c[0], c[1], c.is_learned());
                         s.del_clause(c);
                     }
                     else {
+                        if (s.m_config.m_drat && new_sz < sz) {
+                            s.m_drat.add(new_sz, c.begin());
+                            s.m_drat.del(c);
+                        }
                         c.shrink(new_sz);
                         *it2 = *it;
                         it2++;
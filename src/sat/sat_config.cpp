@@ -29,6 +29,11 @@ namespace sat {
         m_random("random"),
         m_geometric("geometric"),
         m_luby("luby"),
+        m_ema("ema"),
+        m_vsids("vsids"),
+        m_evsids("evsids"),
+        m_vmtf("vmtf"),
+        m_tier("tier"),
         m_dyn_psm("dyn_psm"),
         m_psm("psm"),
         m_glue("glue"),
@@ -46,9 +51,24 @@ namespace sat {
             m_restart = RS_LUBY;
         else if (s == m_geometric)
             m_restart = RS_GEOMETRIC;
+        else if (s == m_ema)
+            m_restart = RS_EMA;
         else
             throw sat_param_exception("invalid restart strategy");
 
+        s = p.branching();
+        if (s == m_vsids)
+            m_branching_heuristic = BH_VSIDS;
+        else if (s == m_evsids)
+            m_branching_heuristic = BH_EVSIDS;
+        else if (s == m_vmtf)
+            m_branching_heuristic = BH_VMTF;
+        else
+            throw sat_param_exception("invalid branching heuristic");
+        m_branching_decay = p.branching_decay();
+        if (m_branching_decay <= 0 || m_branching_decay >= 1)
+            throw sat_param_exception("branching.decay must be between 0 and 1");
+
         s = p.phase();
         if (s == m_always_false) 
             m_phase = PS_ALWAYS_FALSE;
@@ -66,6 +86,10 @@ namespace sat {
 
         m_restart_initial = p.restart_initial();
         m_restart_factor  = p.restart_factor();
+        m_restart_margin  = p.restart_margin();
+        m_restart_reuse_trail = p.restart_reuse_trail();
+        m_backtrack_scopes    = p.backtrack_scopes();
+        m_backtrack_conflicts = p.backtrack_conflicts();
         
         m_random_freq     = p.random_freq();
         m_random_seed     = p.random_seed();
@@ -75,6 +99,8 @@ namespace sat {
         m_burst_search    = p.burst_search();
         
         m_max_conflicts   = p.max_conflicts();
+        m_num_threads     = p.threads();
+        m_lookahead_cube_depth = p.lookahead_cube_depth();
         
         // These parameters are not exposed
         m_simplify_mult1  = _p.get_uint("simplify_mult1", 300);
@@ -93,7 +119,9 @@ namespace sat {
                 m_gc_k = 255;
         }
         else {
-            if (s == m_glue_psm)
+            if (s == m_tier)
+                m_gc_strategy = GC_TIER;
+            else if (s == m_glue_psm)
                 m_gc_strategy = GC_GLUE_PSM;
             else if (s == m_glue)
                 m_gc_strategy = GC_GLUE;
@@ -106,11 +134,20 @@ namespace sat {
             m_gc_initial      = p.gc_initial();
             m_gc_increment    = p.gc_increment();
         }
+        // the tiers are also used to select the learned clauses for asymmetric branching.
+        m_gc_tier1_lbd    = p.gc_tier1();
+        m_gc_tier2_lbd    = std::max(p.gc_tier1(), p.gc_tier2());
         m_minimize_lemmas = p.minimize_lemmas();
         m_minimize_core   = p.minimize_core();
         m_minimize_core_partial   = p.minimize_core_partial();
         m_optimize_model  = p.optimize_model();
         m_bcd             = p.bcd();
+        m_xor_solver      = p.xor_solver();
+        m_xor_solver_max_rows = p.xor_solver_max_rows();
+        m_cardinality_solver = p.cardinality_solver();
+        m_drat_file       = p.drat_file();
+        m_drat            = m_drat_file != symbol("");
+        m_drat_binary     = p.drat_binary();
         m_dyn_sub_res     = p.dyn_sub_res();
     }
 
@@ -33,10 +33,18 @@ namespace sat {
 
     enum restart_strategy {
         RS_GEOMETRIC,
-        RS_LUBY
+        RS_LUBY,
+        RS_EMA
+    };
+
+    enum branching_heuristic {
+        BH_VSIDS,
+        BH_EVSIDS,
+        BH_VMTF
     };
 
     enum gc_strategy {
+        GC_TIER,
         GC_DYN_PSM,
         GC_PSM,
         GC_GLUE,
@@ -52,10 +60,18 @@ namespace sat {
         restart_strategy   m_restart;
         unsigned           m_restart_initial;
         double             m_restart_factor; // for geometric case
+        double             m_restart_margin; // for ema case
+        bool               m_restart_reuse_trail;
+        unsigned           m_backtrack_scopes;
+        unsigned           m_backtrack_conflicts;
+        branching_heuristic m_branching_heuristic;
+        double             m_branching_decay; // for evsids case
         double             m_random_freq;
         unsigned           m_random_seed;
         unsigned           m_burst_search;
         unsigned           m_max_conflicts;
+        unsigned           m_num_threads;
+        unsigned           m_lookahead_cube_depth;
 
         unsigned           m_simplify_mult1;
         double             m_simplify_mult2;
@@ -66,6 +82,8 @@ namespace sat {
         unsigned           m_gc_increment;
         unsigned           m_gc_small_lbd;
         unsigned           m_gc_k;
+        unsigned           m_gc_tier1_lbd;
+        unsigned           m_gc_tier2_lbd;
 
         bool               m_minimize_lemmas;
         bool               m_dyn_sub_res;
@@ -74,6 +92,14 @@ namespace sat {
         bool               m_optimize_model;
         bool               m_bcd;
 
+        bool               m_xor_solver;
+        unsigned           m_xor_solver_max_rows;
+        bool               m_cardinality_solver;
+
+        bool               m_drat;
+        symbol             m_drat_file;
+        bool               m_drat_binary;
+
 
         symbol             m_always_true;
         symbol             m_always_false;
@@ -81,7 +107,13 @@ namespace sat {
         symbol             m_random;
         symbol             m_geometric;
         symbol             m_luby;
+        symbol             m_ema;
+
+        symbol             m_vsids;
+        symbol             m_evsids;
+        symbol             m_vmtf;
         
+        symbol             m_tier;
         symbol             m_dyn_psm;
         symbol             m_psm;        
         symbol             m_glue;        
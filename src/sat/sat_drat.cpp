@@ -0,0 +1,125 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    sat_drat.cpp
+
+Abstract:
+
+    Produce DRAT proofs.
+
+    The textual format writes one clause per line, terminated by 0.
+    Deletions are prefixed by "d".
+    The binary format writes 'a' or 'd', followed by the literals
+    encoded as variable-length integers 2*var + sign, followed by 0.
+
+Revision History:
+
+--*/
+#include"sat_solver.h"
+#include"sat_drat.h"
+
+namespace sat {
+
+    drat::drat(solver & s):
+        s(s),
+        m_out(0),
+        m_binary(false) {
+    }
+
+    drat::~drat() {
+        if (m_out) {
+            m_out->flush();
+        }
+        dealloc(m_out);
+    }
+
+    void drat::updt_config() {
+        if (!s.m_config.m_drat || m_out) {
+            return;
+        }
+        m_binary = s.m_config.m_drat_binary;
+        std::ios_base::openmode mode = std::ios_base::out | std::ios_base::trunc;
+        if (m_binary) {
+            mode |= std::ios_base::binary;
+        }
+        m_out = alloc(std::ofstream, s.m_config.m_drat_file.str().c_str(), mode);
+        if (!(*m_out)) {
+            dealloc(m_out);
+            m_out = 0;
+            throw solver_exception("could not open file for DRAT proof");
+        }
+    }
+
+    void drat::flush() {
+        if (m_out) {
+            m_out->flush();
+        }
+    }
+
+    void drat::dump(unsigned n, literal const * lits, status st) {
+        std::ostream & out = *m_out;
+        if (st == deleted) {
+            out << "d ";
+        }
+        for (unsigned i = 0; i < n; ++i) {
+            out << lits[i] << " ";
+        }
+        out << "0\n";
+    }
+
+    void drat::put(unsigned n) {
+        // 7 bits per byte, least significant group first,
+        // the high bit marks that more bytes follow.
+        while (n > 127) {
+            m_out->put(static_cast<char>(128 | (n & 127)));
+            n >>= 7;
+        }
+        m_out->put(static_cast<char>(n));
+    }
+
+    void drat::bdump(unsigned n, literal const * lits, status st) {
+        m_out->put(st == deleted ? 'd' : 'a');
+        for (unsigned i = 0; i < n; ++i) {
+            literal l = lits[i];
+            put(2 * l.var() + (l.sign() ? 1 : 0));
+        }
+        m_out->put(0);
+    }
+
+    void drat::add() {
+        emit(0, 0, added);
+    }
+
+    void drat::add(literal l) {
+        emit(1, &l, added);
+    }
+
+    void drat::add(literal l1, literal l2) {
+        literal ls[2] = { l1, l2 };
+        emit(2, ls, added);
+    }
+
+    void drat::add(clause & c) {
+        emit(c.size(), c.begin(), added);
+    }
+
+    void drat::add(unsigned n, literal const * lits) {
+        emit(n, lits, added);
+    }
+
+    void drat::del(literal l1, literal l2) {
+        literal ls[2] = { l1, l2 };
+        emit(2, ls, deleted);
+    }
+
+    void drat::del(clause & c) {
+        emit(c.size(), c.begin(), deleted);
+    }
+
+    void drat::del(unsigned n, literal const * lits) {
+        emit(n, lits, deleted);
+    }
+
+};
@@ -0,0 +1,66 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    sat_drat.h
+
+Abstract:
+
+    Produce DRAT proofs.
+
+    Clause additions and deletions performed by the solver
+    are streamed to a file in either the textual or the binary
+    DRAT format, so that unsatisfiability results can be
+    validated by an external checker (e.g., drat-trim).
+
+    Literals are written using the solver's variable indices.
+    They coincide with the variables of a DIMACS input.
+
+Revision History:
+
+--*/
+#ifndef SAT_DRAT_H_
+#define SAT_DRAT_H_
+
+#include<fstream>
+#include"sat_types.h"
+
+namespace sat {
+
+    class drat {
+        enum status { added, deleted };
+
+        solver &        s;
+        std::ofstream * m_out;
+        bool            m_binary;
+
+        void put(unsigned n);
+        void dump(unsigned n, literal const * lits, status st);
+        void bdump(unsigned n, literal const * lits, status st);
+        void emit(unsigned n, literal const * lits, status st) {
+            if (m_binary) bdump(n, lits, st); else dump(n, lits, st);
+        }
+    public:
+        drat(solver & s);
+        ~drat();
+
+        void updt_config();
+        void flush();
+
+        void add();
+        void add(literal l);
+        void add(literal l1, literal l2);
+        void add(clause & c);
+        void add(unsigned n, literal const * lits);
+        void add(literal_vector const & c) { add(c.size(), c.c_ptr()); }
+
+        void del(literal l1, literal l2);
+        void del(clause & c);
+        void del(unsigned n, literal const * lits);
+        void del(literal_vector const & c) { del(c.size(), c.c_ptr()); }
+    };
+
+};
+
+#endif
@@ -95,6 +95,10 @@ namespace sat {
             }
             if (!c.frozen())
                 m_solver.dettach_clause(c);
+            // the substitution is applied in place, keep the old clause for DRAT.
+            literal_vector old_lits;
+            if (m_solver.m_config.m_drat)
+                old_lits.append(sz, c.begin());
             // apply substitution
             for (i = 0; i < sz; i++) {
                 SASSERT(!m_solver.was_eliminated(c[i].var()));
@@ -122,6 +126,10 @@ namespace sat {
             }
             if (i < sz) {
                 // clause is a tautology or was simplified
+                if (m_solver.m_config.m_drat) {
+                    for (i = 0; i < sz; i++)
+                        c[i] = old_lits[i];
+                }
                 m_solver.del_clause(c);
                 continue; 
             }
@@ -136,6 +144,11 @@ namespace sat {
                 return;
             }
             TRACE("elim_eqs", tout << "after removing duplicates: " << c << " j: " << j << "\n";);
+            if (m_solver.m_config.m_drat) {
+                if (j > 1)
+                    m_solver.m_drat.add(j, c.begin());
+                m_solver.m_drat.del(old_lits);
+            }
             if (j < sz)
                 c.shrink(j);
             else
@@ -153,6 +166,7 @@ namespace sat {
                 m_solver.del_clause(c);
                 break;
             case 2:
+                if (m_solver.m_config.m_drat) m_solver.m_drat.add(c[0], c[1]);
                 m_solver.mk_bin_clause(c[0], c[1], c.is_learned());
                 m_solver.del_clause(c);
                 break;
@@ -179,6 +193,10 @@ namespace sat {
             SASSERT(v != r.var());
             if (m_solver.is_external(v)) {
                 // cannot really eliminate v, since we have to notify extension of future assignments
+                if (m_solver.m_config.m_drat) {
+                    m_solver.m_drat.add(~l, r);
+                    m_solver.m_drat.add(l, ~r);
+                }
                 m_solver.mk_bin_clause(~l, r, false);
                 m_solver.mk_bin_clause(l, ~r, false);
             }
@@ -0,0 +1,462 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    sat_lookahead.cpp
+
+Abstract:
+
+    Lookahead based cube and conquer.
+
+Revision History:
+
+--*/
+#include<algorithm>
+#include"sat_lookahead.h"
+#include"sat_params.hpp"
+#include"z3_omp.h"
+
+namespace sat {
+
+    lookahead::lookahead(solver & s):
+        m_src(s),
+        m_s(s.m_params, m_limit, 0),
+        m_best_score(0) {
+        m_src.rlimit().push_child(&m_limit);
+        updt_params(s.m_params);
+        m_s.copy(s);
+    }
+
+    lookahead::~lookahead() {
+        m_src.rlimit().pop_child();
+    }
+
+    void lookahead::updt_params(params_ref const & _p) {
+        sat_params p(_p);
+        m_config.m_cube_depth     = p.lookahead_cube_depth();
+        m_config.m_max_candidates = p.lookahead_candidates();
+        m_config.m_num_threads    = std::max(1u, p.threads());
+    }
+
+    /**
+       \brief Compute the pre-selection rating of literals.
+
+       h(l) estimates the reduction obtained by falsifying l. It is
+       computed iteratively from the binary clauses (l \/ l2) and ternary
+       clauses (l \/ l2 \/ l3) containing l, where falsifying l implies l2,
+       or turns l2 \/ l3 into a new binary clause:
+
+          h'(l) = 0.1 + sum h(~l2) + sum h(~l2) * h(~l3)
+
+       The values are normalized by their average after each round.
+    */
+    void lookahead::init_rating() {
+        unsigned num_lits = 2 * m_s.num_vars();
+        m_rating.reset();
+        m_rating.resize(num_lits, 1.0);
+        for (unsigned round = 0; round < 2; ++round) {
+            m_rating_tmp.reset();
+            m_rating_tmp.resize(num_lits, 0.1);
+            double sum = 0;
+            for (unsigned l_idx = 0; l_idx < num_lits; ++l_idx) {
+                literal l = to_literal(l_idx);
+                if (m_s.was_eliminated(l.var()))
+                    continue;
+                // clauses containing l are watched by ~l.
+                watch_list const & wlist = m_s.get_wlist(~l);
+                watch_list::const_iterator it  = wlist.begin();
+                watch_list::const_iterator end = wlist.end();
+                double h = 0.1;
+                for (; it != end; ++it) {
+                    switch (it->get_kind()) {
+                    case watched::BINARY:
+                        h += m_rating[(~it->get_literal()).index()];
+                        break;
+                    case watched::TERNARY:
+                        h += m_rating[(~it->get_literal1()).index()] * m_rating[(~it->get_literal2()).index()];
+                        break;
+                    default:
+                        break;
+                    }
+                }
+                m_rating_tmp[l_idx] = h;
+                sum += h;
+            }
+            double avg = num_lits == 0 ? 1.0 : sum / num_lits;
+            for (unsigned l_idx = 0; l_idx < num_lits; ++l_idx) {
+                m_rating[l_idx] = m_rating_tmp[l_idx] / avg;
+            }
+        }
+    }
+
+    void lookahead::select_candidates() {
+        m_candidates.reset();
+        for (bool_var v = 0; v < m_s.num_vars(); ++v) {
+            if (m_s.value(v) != l_undef || m_s.was_eliminated(v) || !m_s.m_decision[v])
+                continue;
+            if (!m_select.empty() && !m_select[v])
+                continue;
+            literal l(v, false);
+            m_candidates.push_back(candidate(v, m_rating[l.index()] * m_rating[(~l).index()]));
+        }
+        std::sort(m_candidates.begin(), m_candidates.end(), candidate_lt());
+        if (m_candidates.size() > m_config.m_max_candidates) {
+            m_candidates.shrink(m_config.m_max_candidates);
+        }
+    }
+
+    /**
+       \brief Count the ternary clauses that were turned into binary
+       clauses by the literals assigned since old_trail_sz.
+    */
+    double lookahead::count_new_binaries(unsigned old_trail_sz) {
+        double r = 0;
+        for (unsigned i = old_trail_sz; i < m_s.m_trail.size(); ++i) {
+            // the ternary clauses watched by l contain ~l, which is now false.
+            watch_list const & wlist = m_s.get_wlist(m_s.m_trail[i]);
+            watch_list::const_iterator it  = wlist.begin();
+            watch_list::const_iterator end = wlist.end();
+            for (; it != end; ++it) {
+                if (it->is_ternary_clause() &&
+                    m_s.value(it->get_literal1()) == l_undef &&
+                    m_s.value(it->get_literal2()) == l_undef) {
+                    r += 1;
+                }
+            }
+        }
+        return r;
+    }
+
+    /**
+       \brief Assert ~l at the current level, where l is a failed literal.
+       Return false if this produces a conflict.
+    */
+    bool lookahead::assign_failed(literal l) {
+        TRACE("sat_lookahead", tout << "failed literal: " << l << "\n";);
+        m_stats.m_failed_literals++;
+        m_cube.push_back(~l);
+        m_s.assign(~l, justification());
+        m_s.propagate(false);
+        return !m_s.inconsistent();
+    }
+
+    /**
+       \brief Look ahead on the candidates under the assignment of l,
+       which is already propagated. Failed literals found at this
+       second level are asserted under l. Return false if l is a failed literal.
+    */
+    bool lookahead::double_look(literal l) {
+        m_stats.m_double_lookaheads++;
+        unsigned sz = std::min(m_candidates.size(), m_config.m_dl_max_candidates);
+        for (unsigned i = 0; i < sz; ++i) {
+            literal lit(m_candidates[i].m_var, false);
+            for (unsigned j = 0; j < 2; ++j, lit.neg()) {
+                if (m_s.value(lit) != l_undef)
+                    continue;
+                m_s.push();
+                m_s.assign(lit, justification());
+                m_s.propagate(false);
+                m_stats.m_propagations++;
+                bool conflict = m_s.inconsistent();
+                m_s.pop(1);
+                if (conflict) {
+                    m_s.assign(~lit, justification());
+                    m_s.propagate(false);
+                    if (m_s.inconsistent())
+                        return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    double lookahead::look(literal l, bool & failed) {
+        SASSERT(m_s.value(l) == l_undef);
+        unsigned old_trail_sz = m_s.m_trail.size();
+        m_s.push();
+        m_s.assign(l, justification());
+        m_s.propagate(false);
+        m_stats.m_propagations++;
+        double score = 0;
+        failed = m_s.inconsistent();
+        if (!failed) {
+            score = count_new_binaries(old_trail_sz);
+            if (score > 0 && score >= m_config.m_dl_threshold * m_best_score) {
+                failed = !double_look(l);
+            }
+        }
+        m_s.pop(1);
+        return score;
+    }
+
+    /**
+       \brief Look ahead on the candidate variables, assert failed literals,
+       and return the literal to branch on. Return null_literal if all
+       variables are assigned or if a conflict was found.
+    */
+    literal lookahead::choose() {
+        m_score.reset();
+        m_score.resize(2 * m_s.num_vars(), 0);
+        while (true) {
+            select_candidates();
+            if (m_candidates.empty())
+                return null_literal;
+            bool found_failed = false;
+            m_best_score = 0;
+            for (unsigned i = 0; i < m_candidates.size(); ++i) {
+                m_s.checkpoint();
+                literal l(m_candidates[i].m_var, false);
+                for (unsigned j = 0; j < 2; ++j, l.neg()) {
+                    if (m_s.value(l) != l_undef)
+                        continue;
+                    bool failed = false;
+                    double score = look(l, failed);
+                    if (failed) {
+                        found_failed = true;
+                        if (!assign_failed(l))
+                            return null_literal;
+                    }
+                    else {
+                        m_score[l.index()] = score;
+                        m_best_score = std::max(m_best_score, score);
+                    }
+                }
+            }
+            if (found_failed)
+                continue;
+            // select the variable maximizing the product of the scores of its literals.
+            literal best = null_literal;
+            double best_rating = -1;
+            for (unsigned i = 0; i < m_candidates.size(); ++i) {
+                literal l(m_candidates[i].m_var, false);
+                double pos = m_score[l.index()], neg = m_score[(~l).index()];
+                double rating = 1024 * pos * neg + pos + neg;
+                if (rating > best_rating) {
+                    best_rating = rating;
+                    best = pos >= neg ? l : ~l;
+                }
+            }
+            return best;
+        }
+    }
+
+    void lookahead::cube(unsigned depth) {
+        literal l = choose();
+        if (m_s.inconsistent()) {
+            m_stats.m_refuted_cubes++;
+            return;
+        }
+        if (l == null_literal || depth == 0) {
+            m_stats.m_cubes++;
+            m_cubes.push_back(m_cube);
+            return;
+        }
+        unsigned sz = m_cube.size();
+        for (unsigned i = 0; i < 2; ++i, l.neg()) {
+            m_s.push();
+            m_cube.push_back(l);
+            m_s.assign(l, justification());
+            m_s.propagate(false);
+            if (m_s.inconsistent()) {
+                m_stats.m_refuted_cubes++;
+            }
+            else {
+                cube(depth - 1);
+            }
+            m_s.pop(1);
+            m_cube.shrink(sz);
+        }
+    }
+
+    void lookahead::get_cubes(vector<literal_vector> & cubes) {
+        m_cube.reset();
+        m_cubes.reset();
+        m_s.propagate(false);
+        if (!m_s.inconsistent()) {
+            init_rating();
+            cube(m_config.m_cube_depth);
+        }
+        IF_VERBOSE(2, verbose_stream() << "(sat.lookahead :cubes " << m_stats.m_cubes
+                   << " :refuted " << m_stats.m_refuted_cubes
+                   << " :failed-literals " << m_stats.m_failed_literals << ")\n";);
+        cubes.reset();
+        cubes.append(m_cubes);
+    }
+
+    /**
+       \brief Follow the best branch of the lookahead tree down to the given depth.
+       When lookahead refutes the current branch, the negation of its last decision
+       is asserted instead, so the selected cube is not refuted by propagation.
+       The assertions of the user scopes of the source solver are enforced.
+    */
+    lbool lookahead::select_cube(unsigned depth, bool_var_vector const & vars, literal_vector & lits) {
+        lits.reset();
+        m_cube.reset();
+        m_select.reset();
+        m_select.resize(m_s.num_vars(), false);
+        for (unsigned i = 0; i < vars.size(); ++i) {
+            if (vars[i] < m_s.num_vars())
+                m_select[vars[i]] = true;
+        }
+        literal_vector const & scope_lits = m_s.m_user_scope_literals;
+        for (unsigned i = 0; !m_s.inconsistent() && i < scope_lits.size(); ++i) {
+            if (m_s.value(scope_lits[i]) == l_undef)
+                m_s.assign(~scope_lits[i], justification());
+        }
+        m_s.propagate(false);
+        if (!m_s.inconsistent())
+            init_rating();
+        while (true) {
+            if (m_s.inconsistent()) {
+                if (lits.empty())
+                    return l_false;
+                literal d = lits.back();
+                lits.pop_back();
+                m_stats.m_refuted_cubes++;
+                m_s.pop(1);
+                m_s.assign(~d, justification());
+                m_s.propagate(false);
+                continue;
+            }
+            if (lits.size() >= depth)
+                break;
+            literal l = choose();
+            if (m_s.inconsistent())
+                continue;
+            if (l == null_literal)
+                break;
+            m_s.push();
+            lits.push_back(l);
+            m_s.assign(l, justification());
+            m_s.propagate(false);
+        }
+        m_stats.m_cubes++;
+        IF_VERBOSE(2, verbose_stream() << "(sat.lookahead :cube " << lits.size()
+                   << " :refuted " << m_stats.m_refuted_cubes
+                   << " :failed-literals " << m_stats.m_failed_literals << ")\n";);
+        return l_true;
+    }
+
+    /**
+       \brief Solve the cubes using a pool of solvers.
+       Each solver takes the next unsolved cube until a cube is satisfiable,
+       or all cubes are refuted.
+    */
+    lbool lookahead::conquer() {
+        int num_cubes = m_cubes.size();
+        if (num_cubes == 0)
+            return l_false;
+        int num_threads = std::min(static_cast<int>(m_config.m_num_threads), num_cubes);
+        params_ref p(m_src.m_params);
+        p.set_uint("lookahead.cube_depth", 0);
+        p.set_uint("threads", 1);
+        scoped_ptr_vector<reslimit> limits;
+        scoped_ptr_vector<solver> solvers;
+        for (int i = 0; i < num_threads; ++i) {
+            reslimit * lim = alloc(reslimit);
+            limits.push_back(lim);
+            m_src.rlimit().push_child(lim);
+            solver * s = alloc(solver, p, *lim, 0);
+            solvers.push_back(s);
+            s->copy(m_src);
+            // assumptions must not be eliminated by the solver.
+            for (int j = 0; j < num_cubes; ++j) {
+                literal_vector const & c = m_cubes[j];
+                for (unsigned k = 0; k < c.size(); ++k) {
+                    s->m_external[c[k].var()] = true;
+                }
+            }
+        }
+        int next_cube = 0;
+        int finished_id = -1;
+        bool done = false;
+        lbool result = l_false;
+        std::string ex_msg(Z3_CANCELED_MSG);
+        unsigned error_code = 0;
+        IF_VERBOSE(2, verbose_stream() << "(sat.lookahead :conquer " << num_cubes << " :threads " << num_threads << ")\n";);
+        #pragma omp parallel for
+        for (int i = 0; i < num_threads; ++i) {
+            try {
+                while (true) {
+                    int idx = -1;
+                    #pragma omp critical (sat_lookahead)
+                    {
+                        if (!done && next_cube < num_cubes) {
+                            idx = next_cube++;
+                        }
+                    }
+                    if (idx == -1)
+                        break;
+                    literal_vector const & c = m_cubes[idx];
+                    lbool r = solvers[i]->check(c.size(), c.c_ptr());
+                    if (r == l_false)
+                        continue;
+                    bool first = false;
+                    #pragma omp critical (sat_lookahead)
+                    {
+                        if (!done) {
+                            done = true;
+                            first = true;
+                            finished_id = i;
+                            result = r;
+                        }
+                    }
+                    if (first) {
+                        for (int j = 0; j < num_threads; ++j) {
+                            if (j != i) limits[j]->cancel();
+                        }
+                    }
+                    break;
+                }
+            }
+            catch (z3_error & err) {
+                #pragma omp critical (sat_lookahead)
+                {
+                    if (!done) {
+                        done = true;
+                        error_code = err.error_code();
+                    }
+                }
+            }
+            catch (z3_exception & ex) {
+                #pragma omp critical (sat_lookahead)
+                {
+                    if (!done) {
+                        done = true;
+                        ex_msg = ex.msg();
+                    }
+                }
+            }
+        }
+        for (int i = 0; i < num_threads; ++i) {
+            m_src.rlimit().pop_child();
+        }
+        if (done && finished_id == -1) {
+            if (error_code != 0) {
+                throw z3_error(error_code);
+            }
+            throw solver_exception(ex_msg.c_str());
+        }
+        if (result == l_true) {
+            m_model.reset();
+            m_model.append(solvers[finished_id]->get_model());
+        }
+        return result;
+    }
+
+    lbool lookahead::operator()() {
+        vector<literal_vector> cubes;
+        get_cubes(cubes);
+        return conquer();
+    }
+
+    void lookahead::collect_statistics(statistics & st) const {
+        st.update("lh propagations", m_stats.m_propagations);
+        st.update("lh failed literals", m_stats.m_failed_literals);
+        st.update("lh double lookaheads", m_stats.m_double_lookaheads);
+        st.update("lh cubes", m_stats.m_cubes);
+        st.update("lh refuted cubes", m_stats.m_refuted_cubes);
+    }
+
+};
@@ -0,0 +1,133 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    sat_lookahead.h
+
+Abstract:
+
+    Lookahead based cube and conquer.
+
+    Variables are pre-selected by a rating computed over binary
+    and ternary clauses, and the candidates are then scored by
+    propagating both polarities and counting the ternary clauses
+    that become binary. Literals whose propagation conflicts are
+    failed literals and their negation is asserted; candidates with
+    a high score are additionally probed by a second level of
+    lookahead (double lookahead).
+
+    The search tree built by branching on the best candidates is
+    cut at a given depth and each open leaf is returned as a cube.
+    Cubes are conquered by a pool of CDCL solvers that receive
+    them as assumptions.
+
+    Single cubes can also be selected one at a time, so that a
+    client can enumerate a partition of the problem by asserting
+    the negation of each cube before selecting the next one.
+
+Revision History:
+
+--*/
+#ifndef SAT_LOOKAHEAD_H_
+#define SAT_LOOKAHEAD_H_
+
+#include"sat_types.h"
+#include"sat_solver.h"
+#include"scoped_ptr_vector.h"
+#include"statistics.h"
+
+namespace sat {
+
+    class lookahead {
+        struct config {
+            unsigned m_cube_depth;      // maximal number of decisions in a cube
+            unsigned m_max_candidates;  // number of variables that are looked ahead
+            double   m_dl_threshold;    // relative score above which double lookahead is used
+            unsigned m_dl_max_candidates;
+            unsigned m_num_threads;
+            config():
+                m_cube_depth(10),
+                m_max_candidates(32),
+                m_dl_threshold(0.9),
+                m_dl_max_candidates(8),
+                m_num_threads(1) {}
+        };
+
+        struct stats {
+            unsigned m_propagations;
+            unsigned m_failed_literals;
+            unsigned m_double_lookaheads;
+            unsigned m_cubes;
+            unsigned m_refuted_cubes;
+            stats() { reset(); }
+            void reset() { memset(this, 0, sizeof(*this)); }
+        };
+
+        struct candidate {
+            bool_var m_var;
+            double   m_rating;
+            candidate(bool_var v, double r): m_var(v), m_rating(r) {}
+        };
+
+        struct candidate_lt {
+            bool operator()(candidate const & c1, candidate const & c2) const { return c1.m_rating > c2.m_rating; }
+        };
+
+        solver &                    m_src;
+        reslimit                    m_limit;
+        solver                      m_s;        // copy of m_src that is split into cubes
+        config                      m_config;
+        stats                       m_stats;
+        svector<double>             m_rating;   // pre-selection heuristic, indexed by literal
+        svector<double>             m_rating_tmp;
+        svector<candidate>          m_candidates;
+        svector<double>             m_score;    // lookahead score, indexed by literal
+        double                      m_best_score;
+        literal_vector              m_cube;     // decisions and failed literals on the current branch
+        svector<bool>               m_select;   // variables that may be chosen, all variables if empty
+        vector<literal_vector>      m_cubes;
+        model                       m_model;
+
+        void init_rating();
+        void select_candidates();
+        double count_new_binaries(unsigned old_trail_sz);
+        bool assign_failed(literal l);
+        bool double_look(literal l);
+        double look(literal l, bool & failed);
+        literal choose();
+        void cube(unsigned depth);
+        lbool conquer();
+
+    public:
+        lookahead(solver & s);
+        ~lookahead();
+
+        void updt_params(params_ref const & p);
+
+        /**
+           \brief Split the problem into cubes. A problem without cubes is unsatisfiable.
+        */
+        void get_cubes(vector<literal_vector> & cubes);
+
+        /**
+           \brief Select a cube of at most depth decisions over the variables vars.
+           Return l_false if the problem is unsatisfiable.
+        */
+        lbool select_cube(unsigned depth, bool_var_vector const & vars, literal_vector & lits);
+
+        /**
+           \brief Split the problem into cubes and solve them in parallel.
+           The model (before applying the model converter of the source solver)
+           is available when the result is l_true.
+        */
+        lbool operator()();
+
+        model const & get_model() const { return m_model; }
+
+        void collect_statistics(statistics & st) const;
+    };
+
+};
+
+#endif
@@ -33,6 +33,41 @@ namespace sat {
         m_entries.finalize();
     }
     
+    /**
+       \brief Remove the entries for variables >= v, and the clauses that contain these variables.
+       The variables were created in a user scope that was popped, and the clauses that contain them
+       were asserted in the same scope.
+    */
+    void model_converter::gc_vars(bool_var v) {
+        unsigned j = 0;
+        for (unsigned i = 0; i < m_entries.size(); ++i) {
+            entry & e = m_entries[i];
+            if (e.var() >= v)
+                continue;
+            literal_vector & cls = e.m_clauses;
+            unsigned k = 0, start = 0;
+            bool keep = true;
+            for (unsigned l = 0; l < cls.size(); ++l) {
+                if (cls[l] == null_literal) {
+                    if (keep) {
+                        for (unsigned r = start; r <= l; ++r)
+                            cls[k++] = cls[r];
+                    }
+                    keep  = true;
+                    start = l + 1;
+                }
+                else if (cls[l].var() >= v) {
+                    keep = false;
+                }
+            }
+            cls.shrink(k);
+            if (i != j)
+                m_entries[j] = e;
+            ++j;
+        }
+        m_entries.shrink(j);
+    }
+
     void model_converter::operator()(model & m) const {
         vector<entry>::const_iterator begin = m_entries.begin();
         vector<entry>::const_iterator it    = m_entries.end();
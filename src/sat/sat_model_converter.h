@@ -68,6 +68,7 @@ namespace sat {
         bool empty() const { return m_entries.empty(); }
 
         void reset();
+        void gc_vars(bool_var v);
         bool check_invariant(unsigned num_vars) const;
         void display(std::ostream & out) const;
         bool check_model(model const & m) const;
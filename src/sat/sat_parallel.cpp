@@ -0,0 +1,173 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    sat_parallel.cpp
+
+Abstract:
+
+    Utilities for running a portfolio of SAT solvers in parallel.
+    Solvers exchange units and short learned clauses through
+    a shared pool.
+
+Revision History:
+
+--*/
+#include"sat_parallel.h"
+#include"sat_solver.h"
+#include"z3_omp.h"
+
+namespace sat {
+
+    void parallel::vector_pool::next(unsigned& index) {
+        SASSERT(index < m_size);
+        unsigned n = index + 2 + get_length(index);
+        index = (n >= m_size) ? 0 : n;
+    }
+
+    void parallel::vector_pool::reserve(unsigned num_owners, unsigned sz) {
+        m_vectors.reset();
+        m_vectors.resize(sz, 0);
+        m_heads.reset();
+        m_heads.resize(num_owners, 0);
+        m_at_end.reset();
+        m_at_end.resize(num_owners, true);
+        m_tail = 0;
+        m_size = sz;
+    }
+
+    void parallel::vector_pool::begin_add_vector(unsigned owner, unsigned n) {
+        SASSERT(m_tail < m_size);
+        unsigned capacity = n + 2;
+        // vectors that start before m_size may extend beyond it.
+        m_vectors.reserve(m_size + capacity, 0);
+        for (unsigned i = 0; i < m_heads.size(); ++i) {
+            // readers whose next vector is about to be overwritten skip ahead.
+            while (m_tail < m_heads[i] && m_heads[i] < m_tail + capacity) {
+                next(m_heads[i]);
+            }
+            m_at_end[i] = false;
+        }
+        m_vectors[m_tail++] = owner;
+        m_vectors[m_tail++] = n;
+    }
+
+    void parallel::vector_pool::end_add_vector() {
+        if (m_tail >= m_size) {
+            m_tail = 0;
+        }
+    }
+
+    bool parallel::vector_pool::get_vector(unsigned owner, unsigned& n, unsigned const*& ptr) {
+        while (m_heads[owner] != m_tail || !m_at_end[owner]) {
+            unsigned head = m_heads[owner];
+            next(m_heads[owner]);
+            m_at_end[owner] = m_heads[owner] == m_tail;
+            if (get_owner(head) != owner) {
+                n   = get_length(head);
+                ptr = get_ptr(head);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    parallel::parallel(solver& s):
+        m_max_clause_size(8),
+        m_max_glue(2),
+        m_parent_limit(s.rlimit()) {
+    }
+
+    parallel::~parallel() {
+        for (unsigned i = 0; i < m_limits.size(); ++i) {
+            m_parent_limit.pop_child();
+        }
+    }
+
+    void parallel::init_solvers(solver& s, unsigned num_extra_solvers) {
+        unsigned num_threads = num_extra_solvers + 1;
+        m_pool.reserve(num_threads, 1 << 16);
+        m_units.reset();
+        m_unit_set.reset();
+        symbol geometric("geometric"), always_false("always_false");
+        for (unsigned i = 0; i < num_extra_solvers; ++i) {
+            // diversify the copies by seed, restart and phase selection strategy.
+            params_ref p(s.m_params);
+            p.set_uint("random_seed", s.m_rand());
+            if (i % 2 == 1) {
+                p.set_sym("restart", geometric);
+            }
+            if (i % 3 == 2) {
+                p.set_sym("phase", always_false);
+            }
+            reslimit* lim = alloc(reslimit);
+            m_limits.push_back(lim);
+            m_parent_limit.push_child(lim);
+            solver* s1 = alloc(solver, p, *lim, 0);
+            m_solvers.push_back(s1);
+            s1->copy(s);
+            s1->set_par(this, i);
+        }
+        s.set_par(this, num_extra_solvers);
+    }
+
+    void parallel::exchange(solver& s, literal_vector const& in, unsigned& limit, literal_vector& out) {
+        #pragma omp critical (par_solver)
+        {
+            for (unsigned i = limit; i < m_units.size(); ++i) {
+                out.push_back(m_units[i]);
+            }
+            for (unsigned i = 0; i < in.size(); ++i) {
+                literal lit = in[i];
+                if (!m_unit_set.contains(lit)) {
+                    m_unit_set.insert(lit);
+                    m_units.push_back(lit);
+                }
+            }
+            limit = m_units.size();
+        }
+    }
+
+    void parallel::share_clause(solver& s, unsigned num_lits, literal const* lits, unsigned glue) {
+        if (!enable_add(num_lits, glue)) {
+            return;
+        }
+        unsigned owner = s.m_par_id;
+        #pragma omp critical (par_solver)
+        {
+            m_pool.begin_add_vector(owner, num_lits);
+            for (unsigned i = 0; i < num_lits; ++i) {
+                m_pool.add_vector_elem(lits[i].index());
+            }
+            m_pool.end_add_vector();
+        }
+    }
+
+    void parallel::get_clauses(solver& s) {
+        unsigned owner = s.m_par_id;
+        unsigned n;
+        unsigned const* ptr;
+        // copy clauses out of the pool so that they can be added
+        // to s without holding the lock.
+        literal_vector& lits = s.m_par_lits;
+        unsigned_vector& sizes = s.m_par_sizes;
+        lits.reset();
+        sizes.reset();
+        #pragma omp critical (par_solver)
+        {
+            while (m_pool.get_vector(owner, n, ptr)) {
+                sizes.push_back(n);
+                for (unsigned i = 0; i < n; ++i) {
+                    lits.push_back(to_literal(ptr[i]));
+                }
+            }
+        }
+        unsigned offset = 0;
+        for (unsigned i = 0; !s.inconsistent() && i < sizes.size(); ++i) {
+            s.add_par_clause(sizes[i], lits.c_ptr() + offset);
+            offset += sizes[i];
+        }
+    }
+
+};
@@ -0,0 +1,96 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    sat_parallel.h
+
+Abstract:
+
+    Utilities for running a portfolio of SAT solvers in parallel.
+    Solvers exchange units and short learned clauses through
+    a shared pool.
+
+Revision History:
+
+--*/
+#ifndef SAT_PARALLEL_H_
+#define SAT_PARALLEL_H_
+
+#include"sat_types.h"
+#include"sat_clause.h"
+#include"rlimit.h"
+#include"scoped_ptr_vector.h"
+
+namespace sat {
+
+    class solver;
+
+    class parallel {
+
+        // shared pool of learned clauses.
+        // Vectors are stored as (owner, size, elem_1, ..., elem_size)
+        // in a ring buffer. Readers that fall behind the writer lose
+        // the vectors that get overwritten.
+        class vector_pool {
+            unsigned_vector m_vectors;
+            unsigned        m_size;
+            unsigned        m_tail;
+            unsigned_vector m_heads;
+            svector<bool>   m_at_end;
+            void next(unsigned& index);
+            unsigned get_owner(unsigned index) const { return m_vectors[index]; }
+            unsigned get_length(unsigned index) const { return m_vectors[index+1]; }
+            unsigned const* get_ptr(unsigned index) const { return m_vectors.c_ptr() + index + 2; }
+        public:
+            vector_pool(): m_size(0), m_tail(0) {}
+            void reserve(unsigned num_owners, unsigned sz);
+            void begin_add_vector(unsigned owner, unsigned n);
+            void add_vector_elem(unsigned e) { m_vectors[m_tail++] = e; }
+            void end_add_vector();
+            bool get_vector(unsigned owner, unsigned& n, unsigned const*& ptr);
+        };
+
+        unsigned                    m_max_clause_size;
+        unsigned                    m_max_glue;
+        scoped_ptr_vector<reslimit> m_limits;
+        scoped_ptr_vector<solver>   m_solvers;
+        reslimit&                   m_parent_limit;
+
+        // units exchanged between solvers.
+        literal_vector              m_units;
+        literal_set                 m_unit_set;
+        // learned clauses exchanged between solvers.
+        vector_pool                 m_pool;
+
+        bool enable_add(unsigned num_lits, unsigned glue) const {
+            return num_lits <= m_max_clause_size && glue <= m_max_glue;
+        }
+
+    public:
+
+        parallel(solver& s);
+
+        ~parallel();
+
+        void init_solvers(solver& s, unsigned num_extra_solvers);
+
+        unsigned num_solvers() const { return m_solvers.size(); }
+
+        solver& get_solver(unsigned i) { return *m_solvers[i]; }
+
+        void cancel_solver(unsigned i) { m_limits[i]->cancel(); }
+
+        // exchange unit literals
+        void exchange(solver& s, literal_vector const& in, unsigned& limit, literal_vector& out);
+
+        // add learned clause to the shared pool
+        void share_clause(solver& s, unsigned num_lits, literal const* lits, unsigned glue);
+
+        // receive clauses from the shared pool
+        void get_clauses(solver& s);
+    };
+
+};
+
+#endif
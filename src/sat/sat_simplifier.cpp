@@ -267,6 +267,7 @@ namespace sat {
                 continue;
             }
             if (sz == 2) {
+                if (s.m_config.m_drat) s.m_drat.add(c[0], c[1]);
                 s.mk_bin_clause(c[0], c[1], c.is_learned());
                 s.del_clause(c);
                 continue;
@@ -531,7 +532,7 @@ namespace sat {
             literal l = c[i];
             switch (value(l)) {
             case l_undef:
-                c[j] = l;
+                std::swap(c[j], c[i]);
                 j++;
                 break;
             case l_false:
@@ -544,11 +545,16 @@ namespace sat {
                 break;
             case l_true:
                 r = true;
-                c[j] = l;
+                std::swap(c[j], c[i]);
                 j++;
                 break;
             }
         }
+        if (j < sz && s.m_config.m_drat) {
+            // the literals of c were only permuted, so the original clause can still be deleted.
+            s.m_drat.add(j, c.begin());
+            s.m_drat.del(c);
+        }
         c.shrink(j);
         return r;
     }
@@ -618,6 +624,14 @@ namespace sat {
         m_need_cleanup = true;
         m_num_elim_lits++;
         insert_todo(l.var());
+        if (s.m_config.m_drat) {
+            literal_vector lits;
+            for (unsigned i = 0; i < c.size(); ++i) {
+                if (c[i] != l) lits.push_back(c[i]);
+            }
+            s.m_drat.add(lits);
+            s.m_drat.del(c);
+        }
         c.elim(l);
         clause_use_list & occurs = m_use_list.get(l);
         occurs.erase_not_removed(c);
@@ -641,6 +655,7 @@ namespace sat {
             return;
         case 2:
             TRACE("elim_lit", tout << "clause became binary: " << c[0] << " " << c[1] << "\n";);
+            if (s.m_config.m_drat) s.m_drat.add(c[0], c[1]);
             s.mk_bin_clause(c[0], c[1], c.is_learned());
             m_sub_bin_todo.push_back(bin_clause(c[0], c[1], c.is_learned()));
             remove_clause(c);
@@ -834,6 +849,7 @@ namespace sat {
                 }
                 if (sz == 2) {
                     TRACE("subsumption", tout << "clause became binary: " << c << "\n";);
+                    if (s.m_config.m_drat) s.m_drat.add(c[0], c[1]);
                     s.mk_bin_clause(c[0], c[1], c.is_learned());
                     m_sub_bin_todo.push_back(bin_clause(c[0], c[1], c.is_learned()));
                     remove_clause(c);
@@ -1370,6 +1386,8 @@ namespace sat {
                 TRACE("resolution_new_cls", tout << *it1 << "\n" << *it2 << "\n-->\n" << m_new_cls << "\n";);
                 if (cleanup_clause(m_new_cls))
                     continue; // clause is already satisfied.
+                if (s.m_config.m_drat && m_new_cls.size() > 1)
+                    s.m_drat.add(m_new_cls);
                 switch (m_new_cls.size()) {
                 case 0:
                     s.set_conflict(justification());
@@ -1401,6 +1419,17 @@ namespace sat {
             }
         }
 
+        if (s.m_config.m_drat) {
+            // binary clauses were detached by remove_bin_clauses,
+            // their deletion is logged once the resolvents have been added.
+            for (unsigned i = 0; i < m_pos_cls.size(); ++i) {
+                if (m_pos_cls[i].is_binary()) s.m_drat.del(m_pos_cls[i][0], m_pos_cls[i][1]);
+            }
+            for (unsigned i = 0; i < m_neg_cls.size(); ++i) {
+                if (m_neg_cls[i].is_binary()) s.m_drat.del(m_neg_cls[i][0], m_neg_cls[i][1]);
+            }
+        }
+
         return true;
     }
 
@@ -16,11 +16,15 @@ Author:
 Revision History:
 
 --*/
+#include<cmath>
 #include"sat_solver.h"
 #include"sat_integrity_checker.h"
 #include"luby.h"
 #include"trace.h"
 #include"sat_bceq.h"
+#include"sat_parallel.h"
+#include"sat_lookahead.h"
+#include"z3_omp.h"
 
 // define to update glue during propagation
 #define UPDATE_GLUE
@@ -36,6 +40,7 @@ namespace sat {
         m_config(p),
         m_ext(ext),
         m_cleaner(*this),
+        m_drat(*this),
         m_simplifier(*this, p),
         m_scc(*this, p),
         m_asymm_branch(*this, p),
@@ -46,10 +51,29 @@ namespace sat {
         m_num_frozen(0),
         m_activity_inc(128),
         m_case_split_queue(m_activity),
+        m_fast_glue_avg(3e-2),
+        m_slow_glue_avg(1e-5),
         m_qhead(0),
         m_scope_lvl(0),
-        m_params(p) {
+        m_params(p),
+        m_par(0),
+        m_par_id(0),
+        m_par_num_vars(0),
+        m_par_limit_in(0),
+        m_par_limit_out(0) {
         updt_params(p);
+        // the owned extensions cannot justify their inferences in DRAT proofs,
+        // and only one extension is used at a time.
+        if (!m_ext && !m_config.m_drat) {
+            if (m_config.m_cardinality_solver) {
+                m_card_solver = alloc(card_solver, *this);
+                m_ext = m_card_solver.get();
+            }
+            else if (m_config.m_xor_solver) {
+                m_xor_solver = alloc(xor_solver, *this);
+                m_ext = m_xor_solver.get();
+            }
+        }
         m_conflicts_since_gc      = 0;
         m_conflicts               = 0;
         m_next_simplify           = 0;
@@ -73,21 +97,30 @@ namespace sat {
     }
 
     void solver::copy(solver const & src) {
-        SASSERT(m_mc.empty() && src.m_mc.empty());
+        SASSERT(m_mc.empty());
+        pop_to_base_level();
         // create new vars
+        // Variables eliminated in src do not occur in its clauses, 
+        // they are assigned by the model converter of src.
         if (num_vars() < src.num_vars()) {
             for (bool_var v = num_vars(); v < src.num_vars(); v++) {
-                SASSERT(!src.was_eliminated(v));
                 bool ext  = src.m_external[v] != 0;
                 bool dvar = src.m_decision[v] != 0;
                 bool_var new_v = mk_var(ext, dvar);
                 SASSERT(v == new_v);
             }
         }
+        {
+            // copy units
+            unsigned trail_sz = src.m_scopes.empty() ? src.m_trail.size() : src.m_scopes[0].m_trail_lim;
+            for (unsigned i = 0; !inconsistent() && i < trail_sz; ++i) {
+                assign(src.m_trail[i], justification());
+            }
+        }
         {
             // copy binary clauses
             vector<watch_list>::const_iterator it  = src.m_watches.begin();
-            vector<watch_list>::const_iterator end = src.m_watches.begin();
+            vector<watch_list>::const_iterator end = src.m_watches.end();
             for (unsigned l_idx = 0; it != end; ++it, ++l_idx) {
                 watch_list const & wlist = *it;
                 literal l = ~to_literal(l_idx);
@@ -97,6 +130,8 @@ namespace sat {
                     if (!it2->is_binary_non_learned_clause())
                         continue;
                     literal l2 = it2->get_literal();
+                    if (l.index() > l2.index()) 
+                        continue;
                     mk_clause_core(l, l2);
                 }
             }
@@ -114,6 +149,8 @@ namespace sat {
                 mk_clause_core(buffer);
             }
         }
+        m_user_scope_literals.reset();
+        m_user_scope_literals.append(src.m_user_scope_literals);
     }
 
     // -----------------------
@@ -142,6 +179,7 @@ namespace sat {
         m_prev_phase.push_back(PHASE_NOT_AVAILABLE);
         m_assigned_since_gc.push_back(false);
         m_case_split_queue.mk_var_eh(v);
+        m_vmtf_queue.mk_var_eh(v);
         m_simplifier.insert_todo(v);
         SASSERT(!was_eliminated(v));
         return v;
@@ -176,6 +214,7 @@ namespace sat {
 
     void solver::del_clause(clause& c) {
         if (!c.is_learned()) m_stats.m_non_learned_generation++;
+        if (m_config.m_drat) m_drat.del(c);
         m_cls_allocator.del_clause(&c); 
         m_stats.m_del_clause++; 
     }
@@ -183,13 +222,19 @@ namespace sat {
     clause * solver::mk_clause_core(unsigned num_lits, literal * lits, bool learned) {
         TRACE("sat", tout << "mk_clause: " << mk_lits_pp(num_lits, lits) << "\n";);
         if (!learned) {
+            unsigned old_sz = num_lits;
             bool keep = simplify_clause(num_lits, lits);
             TRACE("sat_mk_clause", tout << "mk_clause (after simp), keep: " << keep << "\n" << mk_lits_pp(num_lits, lits) << "\n";);
             if (!keep) {
                 return 0; // clause is equivalent to true.
             }
             ++m_stats.m_non_learned_generation;
-        }        
+            if (m_config.m_drat && num_lits < old_sz && num_lits > 1) 
+                m_drat.add(num_lits, lits);
+        }
+        else if (m_config.m_drat && num_lits > 1) {
+            m_drat.add(num_lits, lits);
+        }
 
         switch (num_lits) {
         case 0:
@@ -300,7 +345,8 @@ namespace sat {
         reinit = false;
         clause_offset cls_off = m_cls_allocator.get_offset(&c);
         if (scope_lvl() > 0) {
-            if (c.is_learned()) {
+            // a learned clause is attached with the asserting literal at position 0, unless it is reinitialized.
+            if (c.is_learned() && !c.on_reinit_stack()) {
                 unsigned w2_idx = select_learned_watch_lit(c);
                 std::swap(c[1], c[w2_idx]);
             }
@@ -491,13 +537,18 @@ namespace sat {
         m_inconsistent = true;
         m_conflict = c;
         m_not_l    = not_l;
+        if (m_config.m_drat && scope_lvl() == 0) 
+            m_drat.add();
     }
 
     void solver::assign_core(literal l, justification j) {
         SASSERT(value(l) == l_undef);
         TRACE("sat_assign_core", tout << l << "\n";);
-        if (scope_lvl() == 0)
+        if (scope_lvl() == 0) {
             j = justification(); // erase justification for level 0
+            if (m_config.m_drat)
+                m_drat.add(l);
+        }
         m_assignment[l.index()]    = l_true;
         m_assignment[(~l).index()] = l_false;
         bool_var v = l.var();
@@ -679,14 +730,17 @@ namespace sat {
                 case watched::EXT_CONSTRAINT:
                     SASSERT(m_ext);
                     m_ext->propagate(l, it->get_ext_constraint_idx(), keep);
-                    if (keep) {
-                        *it2 = *it;
-                        it2++;
-                    }
                     if (m_inconsistent) {
+                        // the current watch is copied by CONFLICT_CLEANUP if it is kept.
+                        if (!keep)
+                            ++it;
                         CONFLICT_CLEANUP();
                         return false;
                     }
+                    if (keep) {
+                        *it2 = *it;
+                        it2++;
+                    }
                     break;
                 default:
                     UNREACHABLE();
@@ -714,6 +768,13 @@ namespace sat {
     // -----------------------
     lbool solver::check(unsigned num_lits, literal const* lits, double const* weights, double max_weight) {
         pop_to_base_level();
+        if (m_config.m_lookahead_cube_depth > 0 && num_lits == 0 && m_user_scope_literals.empty() &&
+            !m_par && !weights && !m_ext && !m_config.m_drat) {
+            return check_lookahead();
+        }
+        if (m_config.m_num_threads > 1 && !m_par && !weights && !m_ext && !m_config.m_drat) {
+            return check_par(num_lits, lits);
+        }
         IF_VERBOSE(2, verbose_stream() << "(sat.sat-solver)\n";);
         SASSERT(scope_lvl() == 0);
 #ifdef CLONE_BEFORE_SOLVING
@@ -727,6 +788,11 @@ namespace sat {
             init_search();
             propagate(false);
             if (inconsistent()) return l_false;
+            if (m_xor_solver) {
+                m_xor_solver->find_xors();
+                propagate(false);
+                if (inconsistent()) return l_false;
+            }
             init_assumptions(num_lits, lits, weights, max_weight);
             propagate(false);
             if (check_inconsistent()) return l_false;
@@ -764,6 +830,7 @@ namespace sat {
                 }
 
                 restart();
+                if (check_inconsistent()) return l_false;
                 simplify_problem();
                 if (check_inconsistent()) return l_false;                
                 gc();
@@ -774,6 +841,264 @@ namespace sat {
         }
     }
 
+    // -----------------------
+    //
+    // Parallel portfolio
+    //
+    // -----------------------
+
+    void solver::set_par(parallel* p, unsigned id) {
+        m_par = p;
+        m_par_id = id;
+        m_par_num_vars = num_vars();
+        m_par_limit_in = 0;
+        m_par_limit_out = 0;
+    }
+
+    /**
+       \brief Run the main solver together with m_num_threads - 1 copies
+       that use different seeds and strategies. The first solver to finish
+       cancels the others.
+    */
+    lbool solver::check_par(unsigned num_lits, literal const* lits) {
+        int num_threads = static_cast<int>(m_config.m_num_threads);
+        int num_extra_solvers = num_threads - 1;
+        parallel par(*this);
+        par.init_solvers(*this, num_extra_solvers);
+        int finished_id = -1;
+        lbool result = l_undef;
+        bool canceled = false;
+        std::string ex_msg(Z3_CANCELED_MSG);
+        unsigned error_code = 0;
+        IF_VERBOSE(2, verbose_stream() << "(sat.parallel :threads " << num_threads << ")\n";);
+        #pragma omp parallel for
+        for (int i = 0; i < num_threads; ++i) {
+            try {
+                lbool r = l_undef;
+                if (i < num_extra_solvers) {
+                    r = par.get_solver(i).check(num_lits, lits);
+                }
+                else {
+                    r = check(num_lits, lits);
+                }
+                bool first = false;
+                #pragma omp critical (par_solver)
+                {
+                    if (finished_id == -1) {
+                        finished_id = i;
+                        first = true;
+                        result = r;
+                    }
+                }
+                if (first) {
+                    if (i < num_extra_solvers) {
+                        // cancelling the main solver also cancels its children.
+                        canceled = rlimit().get_cancel_flag();
+                        if (!canceled) {
+                            rlimit().cancel();
+                        }
+                    }
+                    else {
+                        for (int j = 0; j < num_extra_solvers; ++j) {
+                            par.cancel_solver(j);
+                        }
+                    }
+                }
+            }
+            catch (z3_error & err) {
+                if (i == num_extra_solvers) {
+                    error_code = err.error_code();
+                }
+            }
+            catch (z3_exception & ex) {
+                if (i == num_extra_solvers) {
+                    ex_msg = ex.msg();
+                }
+            }
+        }
+        set_par(0, 0);
+        if (finished_id == -1) {
+            if (error_code != 0) {
+                throw z3_error(error_code);
+            }
+            throw solver_exception(ex_msg.c_str());
+        }
+        if (finished_id < num_extra_solvers) {
+            if (!canceled) {
+                rlimit().reset_cancel();
+            }
+            solver& s = par.get_solver(finished_id);
+            IF_VERBOSE(2, verbose_stream() << "(sat.parallel :winner " << finished_id << ")\n";);
+            if (result == l_true) {
+                m_model.reset();
+                m_model.append(s.get_model());
+                m_mc(m_model);
+                m_model_is_current = true;
+            }
+            else if (result == l_false) {
+                m_core.reset();
+                m_core.append(s.get_core());
+                if (num_lits == 0 && m_user_scope_literals.empty()) {
+                    pop_to_base_level();
+                    set_conflict(justification());
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+       \brief Split the problem into cubes using lookahead, and
+       solve the cubes in parallel.
+    */
+    lbool solver::check_lookahead() {
+        if (inconsistent()) 
+            return l_false;
+        lookahead lh(*this);
+        lbool r = lh();
+        if (r == l_true) {
+            m_model.reset();
+            m_model.append(lh.get_model());
+            m_mc(m_model);
+            m_model_is_current = true;
+        }
+        else if (r == l_false) {
+            m_core.reset();
+            set_conflict(justification());
+        }
+        return r;
+    }
+
+    /**
+       \brief Select a cube of at most depth literals over vars using lookahead.
+       The result is l_false if the clauses are unsatisfiable. The cube is empty
+       if no variable in vars is left to split on.
+    */
+    lbool solver::cube(unsigned depth, bool_var_vector const& vars, literal_vector& lits) {
+        pop_to_base_level();
+        lits.reset();
+        if (inconsistent())
+            return l_false;
+        lookahead lh(*this);
+        return lh.select_cube(depth, vars, lits);
+    }
+
+    /**
+       \brief Find the literals over vars that are implied by the clauses and the assumptions.
+       For each implied literal l, conseq contains a vector whose first element is l and whose
+       other elements are assumptions that imply l.
+       The models found by the search filter the candidate literals. The remaining candidates
+       are confirmed by checks that assume their negation, so the learned clauses are shared 
+       between the checks.
+    */
+    lbool solver::get_consequences(literal_vector const& asms, bool_var_vector const& vars, vector<literal_vector>& conseq) {
+        lbool is_sat = check(asms.size(), asms.c_ptr());
+        if (is_sat != l_true) 
+            return is_sat;
+        literal_vector lits;
+        for (unsigned i = 0; i < vars.size(); ++i) {
+            bool_var v = vars[i];
+            if (m_model[v] == l_undef)
+                continue;
+            literal lit(v, m_model[v] == l_false);
+            if (value(lit) == l_true && lvl(lit) == 0) {
+                // fixed without assumptions.
+                conseq.push_back(literal_vector());
+                conseq.back().push_back(lit);
+                continue;
+            }
+            lits.push_back(lit);
+        }
+        literal_vector asms1(asms);
+        while (!lits.empty()) {
+            literal lit = lits.back();
+            lits.pop_back();
+            asms1.push_back(~lit);
+            is_sat = check(asms1.size(), asms1.c_ptr());
+            asms1.pop_back();
+            if (is_sat == l_undef) 
+                return l_undef;
+            if (is_sat == l_false) {
+                conseq.push_back(literal_vector());
+                conseq.back().push_back(lit);
+                for (unsigned i = 0; i < m_core.size(); ++i) {
+                    if (m_core[i] != ~lit)
+                        conseq.back().push_back(m_core[i]);
+                }
+                continue;
+            }
+            // the candidates that are false in the new model are not implied.
+            unsigned j = 0;
+            for (unsigned i = 0; i < lits.size(); ++i) {
+                if (value_at(lits[i], m_model) == l_true)
+                    lits[j++] = lits[i];
+            }
+            lits.shrink(j);
+        }
+        IF_VERBOSE(2, verbose_stream() << "(sat.consequences :vars " << vars.size() << " :fixed " << conseq.size() << ")\n";);
+        return l_true;
+    }
+
+    /**
+       \brief Exchange units and learned clauses with the other solvers in the portfolio.
+       Only invoked at base level.
+    */
+    void solver::exchange_par() {
+        if (!m_par || scope_lvl() != 0 || inconsistent()) 
+            return;
+        m_par->get_clauses(*this);
+        if (inconsistent())
+            return;
+        literal_vector units_out, units_in;
+        unsigned sz = m_trail.size();
+        for (unsigned i = m_par_limit_out; i < sz; ++i) {
+            literal lit = m_trail[i];
+            if (lit.var() < m_par_num_vars)
+                units_out.push_back(lit);
+        }
+        m_par_limit_out = sz;
+        m_par->exchange(*this, units_out, m_par_limit_in, units_in);
+        for (unsigned i = 0; !inconsistent() && i < units_in.size(); ++i) {
+            literal lit = units_in[i];
+            if (value(lit) == l_true || was_eliminated(lit.var()))
+                continue;
+            m_stats.m_par_units++;
+            assign(lit, justification());
+        }
+        propagate(false);
+        IF_VERBOSE(3, verbose_stream() << "(sat.parallel :id " << m_par_id << " :units-out " << units_out.size() 
+                   << " :units-in " << units_in.size() << ")\n";);
+    }
+
+    /**
+       \brief Add learned clause received from another solver in the portfolio.
+       Clauses that mention variables eliminated by this solver are ignored.
+    */
+    void solver::add_par_clause(unsigned num_lits, literal const* lits) {
+        SASSERT(scope_lvl() == 0);
+        literal_vector buffer;
+        for (unsigned i = 0; i < num_lits; ++i) {
+            literal lit = lits[i];
+            if (lit.var() >= num_vars() || was_eliminated(lit.var()))
+                return;
+            switch (value(lit)) {
+            case l_true:
+                return;
+            case l_false:
+                break;
+            case l_undef:
+                buffer.push_back(lit);
+                break;
+            }
+        }
+        m_stats.m_par_clauses++;
+        TRACE("sat", tout << "par clause: " << buffer << "\n";);
+        clause * c = mk_clause_core(buffer.size(), buffer.c_ptr(), true);
+        if (c) {
+            c->set_glue(buffer.size());
+        }
+    }
+
     bool_var solver::next_var() {
         bool_var next;
 
@@ -786,6 +1111,15 @@ namespace sat {
                 return next;
         }
 
+        if (m_config.m_branching_heuristic == BH_VMTF) {
+            while (!m_vmtf_queue.empty()) {
+                next = m_vmtf_queue.next_var();
+                if (value(next) == l_undef && !was_eliminated(next))
+                    return next;
+            }
+            return null_bool_var;
+        }
+
         while (!m_case_split_queue.empty()) {
             next = m_case_split_queue.next_var();
             if (value(next) == l_undef && !was_eliminated(next))
@@ -845,7 +1179,7 @@ namespace sat {
                     return l_false;
                 if (m_conflicts > m_config.m_max_conflicts)
                     return l_undef;
-                if (m_conflicts_since_restart > m_restart_threshold)
+                if (should_restart())
                     return l_undef;
                 if (scope_lvl() == 0) {
                     cleanup(); // cleaner may propagate frozen clauses
@@ -1147,6 +1481,12 @@ namespace sat {
         m_scc();
         CASSERT("sat_simplify_bug", check_invariant());
 
+        if (m_xor_solver) {
+            // before variable elimination removes the variables of XOR chains.
+            m_xor_solver->find_xors();
+            CASSERT("sat_simplify_bug", check_invariant());
+        }
+
         m_simplifier(false);
         CASSERT("sat_simplify_bug", check_invariant());
         CASSERT("sat_missed_prop", check_missed_propagation());
@@ -1173,6 +1513,10 @@ namespace sat {
             m_ext->simplify();
         }
 
+        if (m_cls_allocator.num_wasted_words() > m_cls_allocator.num_words() / 2) {
+            compact_clauses();
+        }
+
         TRACE("sat", display(tout << "consistent: " << (!inconsistent()) << "\n"););
 
         reinit_assumptions();
@@ -1212,7 +1556,8 @@ namespace sat {
                 m_model[v] = value(v);
         }
         TRACE("sat_mc_bug", m_mc.display(tout););
-        if (m_config.m_optimize_model) {
+        // local search only knows about the clauses.
+        if (m_config.m_optimize_model && !m_ext) {
             m_wsls.opt(0, 0, false);
         }
         m_mc(m_model);
@@ -1282,6 +1627,9 @@ namespace sat {
                 ok = false;
             }
         }
+        if (m_card_solver && !m_card_solver->check_model(m)) {
+            ok = false;
+        }
         if (ok && !m_mc.check_model(m)) {
             ok = false;
             TRACE("sat", tout << "model: " << m << "\n"; m_mc.display(tout););
@@ -1289,6 +1637,19 @@ namespace sat {
         return ok;
     }
 
+    /**
+       \brief With ema restarts, a restart is triggered when the glue of recently learned
+       clauses is high compared to the long-term average, that is, when the search does
+       not seem to make progress. Restarts are at least restart.initial conflicts apart.
+    */
+    bool solver::should_restart() const {
+        if (m_conflicts_since_restart <= m_restart_threshold)
+            return false;
+        if (m_config.m_restart != RS_EMA)
+            return true;
+        return m_fast_glue_avg > m_config.m_restart_margin * m_slow_glue_avg;
+    }
+
     void solver::restart() {
         m_stats.m_restart++;
         IF_VERBOSE(1,
@@ -1296,7 +1657,15 @@ namespace sat {
                    << " :restarts " << m_stats.m_restart << mk_stat(*this)
                    << " :time " << std::fixed << std::setprecision(2) << m_stopwatch.get_current_seconds() << ")\n";);
         IF_VERBOSE(30, display_status(verbose_stream()););
-        pop_reinit(scope_lvl());
+        unsigned num_scopes = reusable_scopes();
+        if (num_scopes > 0) {
+            m_stats.m_trail_reuse++;
+            m_stats.m_saved_propagations += m_scopes[num_scopes].m_trail_lim;
+        }
+        pop(scope_lvl() - num_scopes);
+        exchange_par();
+        if (!inconsistent())
+            reinit_assumptions();
         m_conflicts_since_restart = 0;
         switch (m_config.m_restart) {
         case RS_GEOMETRIC:
@@ -1306,6 +1675,9 @@ namespace sat {
             m_luby_idx++;
             m_restart_threshold = m_config.m_restart_initial * get_luby(m_luby_idx);
             break;
+        case RS_EMA:
+            m_restart_threshold = m_config.m_restart_initial;
+            break;
         default:
             UNREACHABLE();
             break;
@@ -1313,6 +1685,61 @@ namespace sat {
         CASSERT("sat_restart", check_invariant());
     }
 
+    /**
+       \brief Return the number of scopes that can be kept on a restart.
+       The decisions of the kept scopes are on variables that outrank the variable
+       the next decision would be made on, so the search would make them again
+       after a complete restart, and re-derive the same propagations.
+       The scope for assumptions is always kept.
+    */
+    unsigned solver::reusable_scopes() {
+        if (!m_config.m_restart_reuse_trail || m_par || scope_lvl() == 0)
+            return 0;
+        if (m_conflicts >= m_next_simplify)
+            return 0; // simplify_problem backtracks to the base level.
+        if (m_config.m_gc_strategy == GC_DYN_PSM && m_conflicts_since_gc > m_gc_threshold)
+            return 0; // gc_dyn_psm is only performed at the base level.
+        unsigned num_scopes = tracking_assumptions() ? 1 : 0;
+        bool_var next = peek_next_var();
+        if (next == null_bool_var)
+            return num_scopes;
+        for (; num_scopes < scope_lvl(); ++num_scopes) {
+            unsigned idx = m_scopes[num_scopes].m_trail_lim;
+            if (idx >= m_trail.size() || !outranks(m_trail[idx].var(), next))
+                break;
+        }
+        return num_scopes;
+    }
+
+    bool solver::outranks(bool_var v1, bool_var v2) const {
+        if (m_config.m_branching_heuristic == BH_VMTF)
+            return m_vmtf_queue.stamp(v1) > m_vmtf_queue.stamp(v2);
+        return m_activity[v1] > m_activity[v2];
+    }
+
+    /**
+       \brief Return the variable the next (non-random) decision is made on.
+       Assigned variables removed from the queues are re-inserted when they are unassigned.
+    */
+    bool_var solver::peek_next_var() {
+        if (m_config.m_branching_heuristic == BH_VMTF) {
+            while (!m_vmtf_queue.empty()) {
+                bool_var next = m_vmtf_queue.peek_var();
+                if (value(next) == l_undef && !was_eliminated(next))
+                    return next;
+                m_vmtf_queue.next_var();
+            }
+            return null_bool_var;
+        }
+        while (!m_case_split_queue.empty()) {
+            bool_var next = m_case_split_queue.peek_var();
+            if (value(next) == l_undef && !was_eliminated(next))
+                return next;
+            m_case_split_queue.next_var();
+        }
+        return null_bool_var;
+    }
+
     // -----------------------
     //
     // GC
@@ -1324,6 +1751,9 @@ namespace sat {
             return;
         CASSERT("sat_gc_bug", check_invariant());
         switch (m_config.m_gc_strategy) {
+        case GC_TIER:
+            gc_tier();
+            break;
         case GC_GLUE:
             gc_glue();
             break;
@@ -1347,9 +1777,62 @@ namespace sat {
         }
         m_conflicts_since_gc = 0;
         m_gc_threshold += m_config.m_gc_increment;
+        compact_clauses();
         CASSERT("sat_gc_bug", check_invariant());
     }
 
+    struct activity_gt {
+        svector<double> const & m_activity;
+        activity_gt(svector<double> const & act):m_activity(act) {}
+        bool operator()(bool_var v1, bool_var v2) const { return m_activity[v1] > m_activity[v2]; }
+    };
+
+    /**
+       \brief Move the clauses to a fresh arena, in the order in which they are watched,
+       and release the memory of deleted clauses.
+       Clauses watched by the most active variables are placed first.
+    */
+    void solver::compact_clauses() {
+        m_cls_allocator.begin_relocation();
+        svector<bool_var> vars;
+        for (bool_var v = 0; v < num_vars(); ++v) {
+            vars.push_back(v);
+        }
+        std::stable_sort(vars.begin(), vars.end(), activity_gt(m_activity));
+        for (unsigned i = 0; i < vars.size(); ++i) {
+            for (unsigned sign = 0; sign < 2; ++sign) {
+                watch_list & wlist = get_wlist(literal(vars[i], sign != 0));
+                watch_list::iterator it  = wlist.begin();
+                watch_list::iterator end = wlist.end();
+                for (; it != end; ++it) {
+                    if (it->is_clause())
+                        it->set_clause_offset(m_cls_allocator.relocate(it->get_clause_offset()));
+                }
+            }
+        }
+        // clauses that are not watched, e.g., frozen clauses.
+        for (unsigned i = 0; i < m_clauses.size(); ++i) {
+            m_clauses[i] = m_cls_allocator.relocate(m_clauses[i]);
+        }
+        for (unsigned i = 0; i < m_learned.size(); ++i) {
+            m_learned[i] = m_cls_allocator.relocate(m_learned[i]);
+        }
+        for (unsigned i = 0; i < m_trail.size(); ++i) {
+            justification & js = m_justification[m_trail[i].var()];
+            if (js.is_clause())
+                js = justification(m_cls_allocator.relocate(js.get_clause_offset()));
+        }
+        if (m_conflict.is_clause()) {
+            m_conflict = justification(m_cls_allocator.relocate(m_conflict.get_clause_offset()));
+        }
+        for (unsigned i = 0; i < m_clauses_to_reinit.size(); ++i) {
+            clause_wrapper const & cw = m_clauses_to_reinit[i];
+            if (!cw.is_binary())
+                m_clauses_to_reinit[i] = clause_wrapper(*m_cls_allocator.relocate(cw.get_clause()));
+        }
+        m_cls_allocator.end_relocation();
+    }
+
     /**
        \brief Lex on (glue, size)
     */
@@ -1419,6 +1902,57 @@ namespace sat {
         gc_half("psm-glue");
     }
 
+    /**
+       \brief Lex on (used, glue, size), clauses that were used since the last gc come first.
+    */
+    struct used_glue_lt {
+        bool operator()(clause const * c1, clause const * c2) const {
+            if (c1->was_used() != c2->was_used()) return c1->was_used();
+            if (c1->glue() < c2->glue()) return true;
+            return c1->glue() == c2->glue() && c1->size() < c2->size();
+        }
+    };
+
+    /**
+       \brief Tier based gc. Core clauses (glue <= gc.tier1) are never deleted,
+       tier2 clauses (glue <= gc.tier2) are kept while they are used between two
+       gc rounds, and half of the remaining (local) clauses are deleted.
+    */
+    void solver::gc_tier() {
+        TRACE("sat", tout << "gc\n";);
+        unsigned sz = m_learned.size();
+        unsigned j  = 0;
+        clause_vector local;
+        for (unsigned i = 0; i < sz; i++) {
+            clause & c = *(m_learned[i]);
+            if (c.glue() <= m_config.m_gc_tier1_lbd || (c.glue() <= m_config.m_gc_tier2_lbd && c.was_used())) {
+                c.unmark_used();
+                m_learned[j] = &c;
+                j++;
+            }
+            else {
+                local.push_back(&c);
+            }
+        }
+        std::stable_sort(local.begin(), local.end(), used_glue_lt());
+        unsigned keep = local.size() / 2;
+        for (unsigned i = 0; i < local.size(); i++) {
+            clause & c = *(local[i]);
+            if (i < keep || !can_delete(c)) {
+                c.unmark_used();
+                m_learned[j] = &c;
+                j++;
+            }
+            else {
+                dettach_clause(c);
+                del_clause(c);
+            }
+        }
+        m_stats.m_gc_clause += sz - j;
+        m_learned.shrink(j);
+        IF_VERBOSE(SAT_VB_LVL, verbose_stream() << "(sat-gc :strategy tier :deleted " << (sz - j) << ")\n";);
+    }
+
     /**
        \brief Compute the psm of all learned clauses.
     */
@@ -1566,7 +2100,8 @@ namespace sat {
             case l_false:
                 break;
             case l_undef:
-                c[j] = c[i];
+                // swap keeps the original literals in c, they are needed for logging its deletion.
+                std::swap(c[j], c[i]);
                 j++;
                 break;
             }
@@ -1581,9 +2116,14 @@ namespace sat {
             assign(c[0], justification());
             return false;
         case 2:
+            if (m_config.m_drat) m_drat.add(c[0], c[1]);
             mk_bin_clause(c[0], c[1], true);
             return false;
         default:
+            if (m_config.m_drat && new_sz < sz) {
+                m_drat.add(new_sz, c.begin());
+                m_drat.del(c);
+            }
             c.shrink(new_sz);
             attach_clause(c);
             return true;
@@ -1650,6 +2190,7 @@ namespace sat {
         }
         
         if (m_conflict_lvl == 0) {
+            if (m_config.m_drat) m_drat.add();
             return false;
         }
 
@@ -1699,6 +2240,12 @@ namespace sat {
                 unsigned sz  = c.size();
                 for (; i < sz; i++)
                     process_antecedent(~c[i], num_marks);
+                if (m_config.m_gc_strategy == GC_TIER && c.is_learned() && c.glue() > m_config.m_gc_tier1_lbd) {
+                    // learned clauses move to a better tier when their glue decreases.
+                    unsigned glue = num_diff_levels(sz, c.begin());
+                    if (glue < c.glue())
+                        c.set_glue(glue);
+                }
                 break;
             }
             case justification::EXT_JUSTIFICATION: {
@@ -1755,13 +2302,37 @@ namespace sat {
         }
 
         unsigned glue = num_diff_levels(m_lemma.size(), m_lemma.c_ptr());
+        m_fast_glue_avg.update(glue);
+        m_slow_glue_avg.update(glue);
+
+        if (m_par && m_lemma.size() > 1) {
+            m_par->share_clause(*this, m_lemma.size(), m_lemma.c_ptr(), glue);
+        }
 
-        pop_reinit(m_scope_lvl - new_scope_lvl);
+        // Instead of a long backjump, backtrack chronologically to the level below the conflict.
+        // The lemma then propagates above its assertion level, and is kept in the reinit stack
+        // to be propagated again when the levels above the assertion level are backtracked.
+        unsigned backtrack_lvl = new_scope_lvl;
+        if (m_config.m_backtrack_scopes > 0 && m_lemma.size() > 1 &&
+            m_conflicts > m_config.m_backtrack_conflicts &&
+            m_conflict_lvl > new_scope_lvl + m_config.m_backtrack_scopes) {
+            backtrack_lvl = m_conflict_lvl - 1;
+            m_stats.m_chrono_backtrack++;
+            m_stats.m_saved_propagations += m_scopes[backtrack_lvl].m_trail_lim - m_scopes[new_scope_lvl].m_trail_lim;
+        }
+
+        pop_reinit(m_scope_lvl - backtrack_lvl);
         TRACE("sat_conflict_detail", display(tout); tout << "assignment:\n"; display_assignment(tout););
         clause * lemma = mk_clause_core(m_lemma.size(), m_lemma.c_ptr(), true);
         if (lemma) {
             lemma->set_glue(glue);
         }
+        if (backtrack_lvl > new_scope_lvl) {
+            if (lemma)
+                push_reinit_stack(*lemma);
+            else
+                m_clauses_to_reinit.push_back(clause_wrapper(m_lemma[0], m_lemma[1]));
+        }
         decay_activity();
         updt_phase_counters();
         return true;
@@ -2047,6 +2618,9 @@ namespace sat {
 
         switch (js.get_kind()) {
         case justification::NONE:
+            // an assumption that is false at a lower level is assigned at the current level.
+            if (consequent != null_literal)
+                r = scope_lvl();
             break;
         case justification::BINARY:
             r = std::max(r, lvl(js.get_literal()));
@@ -2524,6 +3098,7 @@ namespace sat {
             bool_var v = l.var();
             SASSERT(value(v) == l_undef);
             m_case_split_queue.unassign_var_eh(v);
+            m_vmtf_queue.unassign_var_eh(v);
         }
         m_trail.shrink(old_sz);
         m_qhead = old_sz;
@@ -2642,8 +3217,11 @@ namespace sat {
         }
         // v is an index of a variable that does not occur in solver state.
         if (v < m_level.size()) {
+            if (m_xor_solver)
+                m_xor_solver->gc_vars(v);
             for (bool_var i = v; i < m_level.size(); ++i) {
                 m_case_split_queue.del_var_eh(i);
+                m_vmtf_queue.del_var_eh(i);
             }
             m_watches.shrink(2*v);
             m_assignment.shrink(2*v);
@@ -2659,6 +3237,7 @@ namespace sat {
             m_prev_phase.shrink(v);
             m_assigned_since_gc.shrink(v);
             m_simplifier.reset_todo();
+            m_mc.gc_vars(v);
         }
     }
 
@@ -2680,6 +3259,8 @@ namespace sat {
                     break;
                 }
             }            
+            if (m_card_solver)
+                m_card_solver->gc_lit(lit);
             gc_var(lit.var());
         }
     }
@@ -2698,6 +3279,7 @@ namespace sat {
     void solver::updt_params(params_ref const & p) {
         m_params = p;
         m_config.updt_params(p);
+        m_drat.updt_config();
         m_simplifier.updt_params(p);
         m_asymm_branch.updt_params(p);
         m_probing.updt_params(p);
@@ -2720,6 +3302,10 @@ namespace sat {
         m_scc.collect_statistics(st);
         m_asymm_branch.collect_statistics(st);
         m_probing.collect_statistics(st);
+        if (m_xor_solver)
+            m_xor_solver->collect_statistics(st);
+        if (m_card_solver)
+            m_card_solver->collect_statistics(st);
     }
 
     void solver::reset_statistics() {
@@ -2728,6 +3314,10 @@ namespace sat {
         m_simplifier.reset_statistics();
         m_asymm_branch.reset_statistics();
         m_probing.reset_statistics();
+        if (m_xor_solver)
+            m_xor_solver->reset_statistics();
+        if (m_card_solver)
+            m_card_solver->reset_statistics();
     }
 
     // -----------------------
@@ -2736,13 +3326,37 @@ namespace sat {
     //
     // -----------------------
 
+    void solver::decay_activity() {
+        switch (m_config.m_branching_heuristic) {
+        case BH_VSIDS:
+            // activities are integral, the increment grows by 10% (rounded down).
+            m_activity_inc = floor(m_activity_inc * 11 / 10);
+            break;
+        case BH_EVSIDS:
+            m_activity_inc /= m_config.m_branching_decay;
+            break;
+        case BH_VMTF:
+            m_vmtf_queue.move_bumped();
+            break;
+        }
+    }
+
     void solver::rescale_activity() {
-        svector<unsigned>::iterator it  = m_activity.begin();
-        svector<unsigned>::iterator end = m_activity.end();
-        for (; it != end; ++it) {
-            *it >>= 14;
+        svector<double>::iterator it  = m_activity.begin();
+        svector<double>::iterator end = m_activity.end();
+        if (m_config.m_branching_heuristic == BH_EVSIDS) {
+            for (; it != end; ++it) {
+                *it *= 1e-100;
+            }
+            m_activity_inc *= 1e-100;
+        }
+        else {
+            // integral activities are divided by 2^14, rounding down.
+            for (; it != end; ++it) {
+                *it = floor(*it / (1 << 14));
+            }
+            m_activity_inc = floor(m_activity_inc / (1 << 14));
         }
-        m_activity_inc >>= 14;
     }
 
     // -----------------------
@@ -3131,6 +3745,11 @@ namespace sat {
         st.update("minimized lits", m_minimized_lits);
         st.update("dyn subsumption resolution", m_dyn_sub_res);
         st.update("blocked correction sets", m_blocked_corr_sets);
+        st.update("par units", m_par_units);
+        st.update("par clauses", m_par_clauses);
+        st.update("trail reuse", m_trail_reuse);
+        st.update("chronological backtracks", m_chrono_backtrack);
+        st.update("saved propagations", m_saved_propagations);
     }
 
     void stats::reset() {
@@ -3150,6 +3769,11 @@ namespace sat {
         m_dyn_sub_res = 0;
         m_non_learned_generation = 0;
         m_blocked_corr_sets = 0;
+        m_par_units = 0;
+        m_par_clauses = 0;
+        m_trail_reuse = 0;
+        m_chrono_backtrack = 0;
+        m_saved_propagations = 0;
     }
 
     void mk_stat::display(std::ostream & out) const {
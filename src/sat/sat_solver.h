@@ -34,11 +34,15 @@ Revision History:
 #include"sat_probing.h"
 #include"sat_mus.h"
 #include"sat_sls.h"
+#include"sat_drat.h"
+#include"sat_xor_solver.h"
+#include"sat_card_solver.h"
 #include"params.h"
 #include"statistics.h"
 #include"stopwatch.h"
 #include"trace.h"
 #include"rlimit.h"
+#include"ema.h"
 
 namespace sat {
 
@@ -62,11 +66,18 @@ namespace sat {
         unsigned m_dyn_sub_res;
         unsigned m_non_learned_generation;
         unsigned m_blocked_corr_sets;
+        unsigned m_par_units;
+        unsigned m_par_clauses;
+        unsigned m_trail_reuse;
+        unsigned m_chrono_backtrack;
+        unsigned m_saved_propagations;
         stats() { reset(); }
         void reset();
         void collect_statistics(statistics & st) const;
     };
     
+    class parallel;
+
     class solver {
     public:
         struct abort_solver {};
@@ -75,9 +86,12 @@ namespace sat {
         config                  m_config;
         stats                   m_stats;
         extension *             m_ext;
+        scoped_ptr<xor_solver>  m_xor_solver;    // owned extension, see xor_solver parameter
+        scoped_ptr<card_solver> m_card_solver;   // owned extension, see cardinality_solver parameter
         random_gen              m_rand;
         clause_allocator        m_cls_allocator;
         cleaner                 m_cleaner;
+        drat                    m_drat;          // DRAT for generating proofs
         model                   m_model;        
         model_converter         m_mc;
         bool                    m_model_is_current;
@@ -105,14 +119,15 @@ namespace sat {
         svector<char>           m_eliminated;
         svector<char>           m_external;
         svector<unsigned>       m_level; 
-        svector<unsigned>       m_activity;
-        unsigned                m_activity_inc;
+        svector<double>         m_activity;
+        double                  m_activity_inc;
         svector<char>           m_phase; 
         svector<char>           m_prev_phase;
         svector<char>           m_assigned_since_gc;
         bool                    m_phase_cache_on;
         unsigned                m_phase_counter; 
         var_queue               m_case_split_queue;
+        vmtf_queue              m_vmtf_queue;
         unsigned                m_qhead;
         unsigned                m_scope_lvl;
         literal_vector          m_trail;
@@ -130,6 +145,14 @@ namespace sat {
         literal_set             m_assumption_set;   // set of enabled assumptions
         literal_vector          m_core;             // unsat core
 
+        parallel*               m_par;
+        unsigned                m_par_id;
+        unsigned                m_par_num_vars;
+        unsigned                m_par_limit_in;
+        unsigned                m_par_limit_out;
+        literal_vector          m_par_lits;
+        unsigned_vector         m_par_sizes;
+
         void del_clauses(clause * const * begin, clause * const * end);
 
         friend class integrity_checker;
@@ -144,6 +167,12 @@ namespace sat {
         friend class sls;
         friend class wsls;
         friend class bceq;
+        friend class parallel;
+        friend class drat;
+        friend class lookahead;
+        friend class xor_finder;
+        friend class xor_solver;
+        friend class card_solver;
         friend struct mk_stat;
     public:
         solver(params_ref const & p, reslimit& l, extension * ext);
@@ -162,12 +191,17 @@ namespace sat {
         void display_status(std::ostream & out) const;
         
         /**
-           \brief Copy (non learned) clauses from src to this solver.
+           \brief Copy (non learned) clauses and units from src to this solver.
            Create missing variables if needed.
            
-           \pre the model converter of src and this must be empty
+           \pre the model converter of this must be empty
         */
         void copy(solver const & src);
+
+        /**
+           \brief Use the given portfolio for exchanging units and learned clauses.
+        */
+        void set_par(parallel* p, unsigned id);
         
         // -----------------------
         //
@@ -180,6 +214,12 @@ namespace sat {
         void mk_clause(literal l1, literal l2);
         void mk_clause(literal l1, literal l2, literal l3);
 
+        /**
+           \brief Return the extension for cardinality and pseudo-Boolean constraints,
+           or 0 if it is not enabled.
+        */
+        card_solver * get_card_solver() const { return m_card_solver.get(); }
+
     protected:
         void del_clause(clause & c);
         clause * mk_clause_core(unsigned num_lits, literal * lits, bool learned);
@@ -284,6 +324,8 @@ namespace sat {
         model const & get_model() const { return m_model; }
         bool model_is_current() const { return m_model_is_current; }
         literal_vector const& get_core() const { return m_core; }
+        lbool get_consequences(literal_vector const& asms, bool_var_vector const& vars, vector<literal_vector>& conseq);
+        lbool cube(unsigned depth, bool_var_vector const& vars, literal_vector& lits);
         model_converter const & get_model_converter() const { return m_mc; }
         void set_model(model const& mdl);
 
@@ -292,6 +334,8 @@ namespace sat {
         unsigned m_conflicts_since_restart;
         unsigned m_restart_threshold;
         unsigned m_luby_idx;
+        ema      m_fast_glue_avg;
+        ema      m_slow_glue_avg;
         unsigned m_conflicts_since_gc;
         unsigned m_gc_threshold;
         unsigned m_num_checkpoints;
@@ -319,9 +363,17 @@ namespace sat {
         bool tracking_assumptions() const;
         bool is_assumption(literal l) const;
         void simplify_problem();
+        lbool check_par(unsigned num_lits, literal const* lits);
+        lbool check_lookahead();
+        void exchange_par();
+        void add_par_clause(unsigned num_lits, literal const* lits);
         void mk_model();
         bool check_model(model const & m) const;
         void restart();
+        bool should_restart() const;
+        unsigned reusable_scopes();
+        bool outranks(bool_var v1, bool_var v2) const;
+        bool_var peek_next_var();
         void sort_watch_lits();
 
         // -----------------------
@@ -337,14 +389,31 @@ namespace sat {
         void gc_psm_glue();
         void save_psm();
         void gc_half(char const * st_name);
+        void gc_tier();
         void gc_dyn_psm();
+        void compact_clauses();
         bool activate_frozen_clause(clause & c);
         unsigned psm(clause const & c) const;
+        /**
+           \brief Ternary clauses justify assignments by their literals, but a
+           DRAT checker must still know the clause when the justification is used.
+        */
+        bool is_ternary_reason(clause const & c) const {
+            for (unsigned i = 0; i < 3; ++i) {
+                literal l = c[i];
+                if (value(l) != l_true)
+                    continue;
+                justification const & jst = m_justification[l.var()];
+                if (jst.is_ternary_clause() && c.contains(jst.get_literal1()) && c.contains(jst.get_literal2()))
+                    return true;
+            }
+            return false;
+        }
         bool can_delete(clause const & c) const {
             if (c.on_reinit_stack())
                 return false;
             if (c.size() == 3)
-                return true; // not needed to justify anything.
+                return !m_config.m_drat || !is_ternary_reason(c); // not needed to justify anything.
             literal l0 = c[0];
             if (value(l0) != l_true)
                 return true;
@@ -435,17 +504,18 @@ namespace sat {
         // -----------------------
     public:
         void inc_activity(bool_var v) {
-            unsigned & act = m_activity[v];
+            if (m_config.m_branching_heuristic == BH_VMTF) {
+                m_vmtf_queue.bump(v);
+                return;
+            }
+            double & act = m_activity[v];
             act += m_activity_inc;
             m_case_split_queue.activity_increased_eh(v);
-            if (act > (1 << 24))
+            if (act > (m_config.m_branching_heuristic == BH_EVSIDS ? 1e100 : (1 << 24)))
                 rescale_activity();
         }
 
-        void decay_activity() {
-            m_activity_inc *= 11;
-            m_activity_inc /= 10;
-        }
+        void decay_activity();
 
     private:
         void rescale_activity();
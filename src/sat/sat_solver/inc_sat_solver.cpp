@@ -29,10 +29,13 @@ Notes:
 #include "simplify_tactic.h"
 #include "goal2sat.h"
 #include "ast_pp.h"
+#include "ast_util.h"
+#include "bv_decl_plugin.h"
 #include "model_smt2_pp.h"
 #include "filter_model_converter.h"
 #include "bit_blaster_model_converter.h"
 #include "ast_translation.h"
+#include "sat_simplifier_params.hpp"
 
 // incremental SAT solver.
 class inc_sat_solver : public solver {
@@ -41,6 +44,7 @@ class inc_sat_solver : public solver {
     goal2sat        m_goal2sat;
     params_ref      m_params;
     bool            m_optimize_model; // parameter
+    bool            m_elim_vars;      // parameter
     expr_ref_vector m_fmls;
     expr_ref_vector m_asmsf;
     unsigned_vector m_fmls_lim;
@@ -67,7 +71,7 @@ class inc_sat_solver : public solver {
 public:
     inc_sat_solver(ast_manager& m, params_ref const& p):
         m(m), m_solver(p, m.limit(), 0),
-        m_params(p), m_optimize_model(false),
+        m_params(p), m_optimize_model(false), m_elim_vars(true),
         m_fmls(m),
         m_asmsf(m),
         m_fmls_head(0),
@@ -76,8 +80,8 @@ public:
         m_num_scopes(0),
         m_dep_core(m),
         m_unknown("no reason given") {
-        m_params.set_bool("elim_vars", false);
-        m_solver.updt_params(m_params);
+        m_elim_vars = sat_simplifier_params(p).elim_vars();
+        updt_elim_vars();
         init_preprocess();
     }
 
@@ -156,10 +160,94 @@ public:
         }
         return r;
     }
+
+    /**
+       \brief Consequences over propositional variables are computed natively by the SAT solver.
+       Other variables are handled by the default implementation.
+    */
+    virtual lbool get_consequences(expr_ref_vector const& asms, expr_ref_vector const& vars, expr_ref_vector& conseq) {
+        for (unsigned i = 0; i < vars.size(); ++i) {
+            if (!m.is_bool(vars[i]) || !is_uninterp_const(vars[i]))
+                return solver::get_consequences(asms, vars, conseq);
+        }
+        m_solver.pop_to_base_level();
+        dep2asm_t dep2asm;
+        m_model = 0;
+        lbool r = internalize_formulas();
+        if (r != l_true) return r;
+        r = internalize_assumptions(asms.size(), asms.c_ptr(), dep2asm);
+        if (r != l_true) return r;
+
+        // variables that are not atoms of the SAT solver are unconstrained.
+        sat::bool_var_vector bvars;
+        u_map<expr*> bvar2var;
+        for (unsigned i = 0; i < vars.size(); ++i) {
+            sat::bool_var v = m_map.to_bool_var(vars[i]);
+            if (v != sat::null_bool_var && !bvar2var.contains(v)) {
+                bvars.push_back(v);
+                bvar2var.insert(v, vars[i]);
+            }
+        }
+        vector<sat::literal_vector> lconseq;
+        r = m_solver.get_consequences(m_asms, bvars, lconseq);
+        if (r == l_false) {
+            if (!asms.empty()) 
+                extract_core(dep2asm);
+            return r;
+        }
+        if (r != l_true) return r;
+
+        u_map<expr*> asm2dep;
+        dep2asm_t::iterator it = dep2asm.begin(), end = dep2asm.end();
+        for (; it != end; ++it) {
+            asm2dep.insert(it->m_value.index(), it->m_key);
+        }
+        for (unsigned i = 0; i < lconseq.size(); ++i) {
+            sat::literal_vector const& lits = lconseq[i];
+            expr_ref_vector ante(m);
+            expr* e;
+            for (unsigned j = 1; j < lits.size(); ++j) {
+                VERIFY(asm2dep.find(lits[j].index(), e));
+                ante.push_back(e);
+            }
+            e = bvar2var.find(lits[0].var());
+            expr_ref head(lits[0].sign() ? m.mk_not(e) : e, m);
+            conseq.push_back(m.mk_implies(mk_and(ante), head));
+        }
+        return l_true;
+    }
+
+    /**
+       \brief Cubes are selected by lookahead over the atoms of the SAT solver that
+       correspond to Boolean constants and to bits of bit-vector constants.
+    */
+    virtual expr_ref cube(unsigned depth) {
+        m_solver.pop_to_base_level();
+        if (internalize_formulas() != l_true)
+            return expr_ref(m.mk_true(), m);
+        expr_ref_vector var2expr(m);
+        mk_cube_atoms(var2expr);
+        sat::bool_var_vector vars;
+        for (unsigned v = 0; v < var2expr.size(); ++v) {
+            if (var2expr.get(v))
+                vars.push_back(v);
+        }
+        sat::literal_vector lits;
+        if (m_solver.cube(depth, vars, lits) == l_false)
+            return expr_ref(m.mk_false(), m);
+        expr_ref_vector fmls(m);
+        for (unsigned i = 0; i < lits.size(); ++i) {
+            expr * e = var2expr.get(lits[i].var());
+            fmls.push_back(lits[i].sign() ? m.mk_not(e) : e);
+        }
+        return mk_and(fmls);
+    }
+
     virtual void push() {
         internalize_formulas();
         m_solver.user_push();
         ++m_num_scopes;
+        if (m_num_scopes == 1) updt_elim_vars();
         m_fmls_lim.push_back(m_fmls.size());
         m_asms_lim.push_back(m_asmsf.size());
         m_fmls_head_lim.push_back(m_fmls_head);
@@ -175,6 +263,7 @@ public:
         SASSERT(n <= m_num_scopes);
         m_solver.user_pop(n);
         m_num_scopes -= n;
+        if (m_num_scopes == 0) updt_elim_vars();
         while (n > 0) {
             m_fmls_head = m_fmls_head_lim.back();
             m_fmls.resize(m_fmls_lim.back());
@@ -209,9 +298,10 @@ public:
     }
     virtual void updt_params(params_ref const & p) {
         m_params = p;
-        m_params.set_bool("elim_vars", false);
-        m_solver.updt_params(m_params);
+        m_elim_vars = sat_simplifier_params(p).elim_vars();
+        updt_elim_vars();
         m_optimize_model = m_params.get_bool("optimize_model", false);
+        m_preprocess = 0; // created again with the new parameters.
     }
     virtual void collect_statistics(statistics & st) const {
         if (m_preprocess) m_preprocess->collect_statistics(st);
@@ -259,6 +349,9 @@ public:
         }
         if (!m_bb_rewriter) {
             m_bb_rewriter = alloc(bit_blaster_rewriter, m, m_params);
+            for (unsigned i = 0; i < m_num_scopes; ++i) {
+                m_bb_rewriter->push();
+            }
         }
         params_ref simp2_p = m_params;
         simp2_p.set_bool("som", true);
@@ -269,28 +362,40 @@ public:
         simp2_p.set_bool("flat", true); // required by som
         simp2_p.set_bool("hoist_mul", false); // required by som
         simp2_p.set_bool("elim_and", true);
+        params_ref card_p = m_params;
+        card_p.set_bool("keep_cardinality_constraints", m_solver.get_card_solver() != 0);
         m_preprocess =
-            and_then(mk_card2bv_tactic(m, m_params),
+            and_then(mk_card2bv_tactic(m, card_p),
                      using_params(mk_simplify_tactic(m), simp2_p),
                      mk_max_bv_sharing_tactic(m),
                      mk_bit_blaster_tactic(m, m_bb_rewriter.get()),
                      //mk_aig_tactic(),
                      using_params(mk_simplify_tactic(m), simp2_p));
-        for (unsigned i = 0; i < m_num_scopes; ++i) {
-            m_bb_rewriter->push();
-        }
         m_preprocess->reset();
     }
 
 private:
 
+    /**
+       \brief Variables that occur in new assertions or assumptions are atoms, and atoms
+       are external to the SAT solver, so the remaining variables can be eliminated.
+       Variables created inside a user scope are removed when the scope is popped,
+       so variable elimination is only enabled at the base scope.
+    */
+    void updt_elim_vars() {
+        m_params.set_bool("elim_vars", m_elim_vars && m_num_scopes == 0);
+        m_solver.updt_params(m_params);
+    }
 
     lbool internalize_goal(goal_ref& g, dep2asm_t& dep2asm) {
         m_mc.reset();
         m_pc.reset();
         m_dep_core.reset();
         m_subgoals.reset();
-        init_preprocess();
+        if (m_preprocess)
+            m_preprocess->reset();
+        else
+            init_preprocess();
         SASSERT(g->models_enabled());
         SASSERT(!g->proofs_enabled());
         TRACE("sat", g->display(tout););
@@ -318,17 +423,35 @@ private:
             m_asms.shrink(0);
             return l_true;
         }
-        goal_ref g = alloc(goal, m, true, true); // models and cores are enabled.
+        // assumptions that are literals over atoms of the SAT solver are not converted again.
+        goal_ref g;
+        sat::literal lit;
         for (unsigned i = 0; i < sz; ++i) {
+            if (is_internalized_literal(asms[i], lit)) {
+                dep2asm.insert(asms[i], lit);
+                continue;
+            }
+            if (!g) g = alloc(goal, m, true, true); // models and cores are enabled.
             g->assert_expr(asms[i], m.mk_leaf(asms[i]));
         }
-        lbool res = internalize_goal(g, dep2asm);
+        lbool res = g ? internalize_goal(g, dep2asm) : l_true;
         if (res == l_true) {
             extract_assumptions(sz, asms, dep2asm);
         }
         return res;
     }
 
+    bool is_internalized_literal(expr* e, sat::literal& lit) {
+        bool sign = m.is_not(e, e);
+        if (!is_uninterp_const(e))
+            return false;
+        sat::bool_var v = m_map.to_bool_var(e);
+        if (v == sat::null_bool_var)
+            return false;
+        lit = sat::literal(v, sign);
+        return true;
+    }
+
     lbool internalize_formulas() {
         if (m_fmls_head == m_fmls.size()) {
             return l_true;
@@ -402,6 +525,45 @@ private:
         }
     }
 
+    /**
+       \brief Map the variables of the SAT solver to the atoms that can occur in a cube.
+       The fresh constants created by the bit-blaster are replaced by the bits of the
+       bit-vector constants they encode. Other fresh constants are not part of the input.
+    */
+    void mk_cube_atoms(expr_ref_vector & var2expr) {
+        bv_util bv(m);
+        obj_map<func_decl, expr*> bit2atom;
+        expr_ref_vector pinned(m);
+        if (m_bb_rewriter) {
+            obj_map<func_decl, expr*> const & const2bits = m_bb_rewriter->const2bits();
+            obj_map<func_decl, expr*>::iterator it = const2bits.begin(), end = const2bits.end();
+            for (; it != end; ++it) {
+                app * bits = to_app(it->m_value);
+                for (unsigned i = 0; i < bits->get_num_args(); ++i) {
+                    expr * bit = bits->get_arg(i);
+                    if (!is_uninterp_const(bit))
+                        continue;
+                    expr * atom = m.mk_eq(bv.mk_extract(i, i, m.mk_const(it->m_key)), bv.mk_numeral(rational::one(), 1));
+                    pinned.push_back(atom);
+                    bit2atom.insert(to_app(bit)->get_decl(), atom);
+                }
+            }
+        }
+        var2expr.resize(m_solver.num_vars());
+        atom2bool_var::iterator it = m_map.begin(), end = m_map.end();
+        for (; it != end; ++it) {
+            expr * n = it->m_key;
+            if (!is_uninterp_const(n) || it->m_value >= var2expr.size())
+                continue;
+            func_decl * f = to_app(n)->get_decl();
+            expr * atom = 0;
+            if (bit2atom.find(f, atom))
+                var2expr.set(it->m_value, atom);
+            else if (!f->is_skolem())
+                var2expr.set(it->m_value, n);
+        }
+    }
+
     void extract_model() {
         TRACE("sat", tout << "retrieve model\n";);
         if (!m_solver.model_is_current()) {
@@ -431,11 +593,12 @@ private:
         }
         m_model = md;
 
+        model_converter_ref mc = m_mc0;
         if (m_bb_rewriter.get() && !m_bb_rewriter->const2bits().empty()) {
-            m_mc0 = concat(m_mc0.get(), mk_bit_blaster_model_converter(m, m_bb_rewriter->const2bits()));
+            mc = concat(mc.get(), mk_bit_blaster_model_converter(m, m_bb_rewriter->const2bits()));
         }
-        if (m_mc0) {
-            (*m_mc0)(m_model);
+        if (mc) {
+            (*mc)(m_model);
         }
         SASSERT(m_model);
 
@@ -19,6 +19,7 @@ Revision History:
 #ifndef SAT_VAR_QUEUE_H_
 #define SAT_VAR_QUEUE_H_
 
+#include<algorithm>
 #include"heap.h"
 #include"sat_types.h"
 
@@ -26,13 +27,13 @@ namespace sat {
     
     class var_queue {
         struct lt {
-            svector<unsigned> & m_activity;
-            lt(svector<unsigned> & act):m_activity(act) {}
+            svector<double> & m_activity;
+            lt(svector<double> & act):m_activity(act) {}
             bool operator()(bool_var v1, bool_var v2) const { return m_activity[v1] > m_activity[v2]; }
         };
         heap<lt>  m_queue;
     public:
-        var_queue(svector<unsigned> & act):m_queue(128, lt(act)) {}
+        var_queue(svector<double> & act):m_queue(128, lt(act)) {}
         
         void activity_increased_eh(bool_var v) {
             if (m_queue.contains(v))
@@ -61,6 +62,117 @@ namespace sat {
         bool empty() const { return m_queue.empty(); }
 
         bool_var next_var() { SASSERT(!empty()); return m_queue.erase_min(); }
+
+        bool_var peek_var() const { SASSERT(!empty()); return m_queue.min_value(); }
+    };
+
+    /**
+       \brief Variable move-to-front queue.
+
+       Variables are kept in a list ordered by the time they were last bumped.
+       Variables bumped during a conflict are moved to the end of the list, and
+       decisions are made on the most recently bumped unassigned variable.
+       All the variables after m_search in the list are assigned.
+    */
+    class vmtf_queue {
+        struct link {
+            bool_var m_prev;
+            bool_var m_next;
+            uint64   m_stamp;
+            link():m_prev(null_bool_var), m_next(null_bool_var), m_stamp(0) {}
+        };
+
+        struct stamp_lt {
+            svector<link> const & m_links;
+            stamp_lt(svector<link> const & links):m_links(links) {}
+            bool operator()(bool_var v1, bool_var v2) const { return m_links[v1].m_stamp < m_links[v2].m_stamp; }
+        };
+
+        svector<link>   m_links;
+        bool_var        m_first;   // least recently bumped
+        bool_var        m_last;    // most recently bumped
+        bool_var        m_search;
+        uint64          m_stamp;
+        bool_var_vector m_bumped;
+
+        void dequeue(bool_var v) {
+            link & l = m_links[v];
+            if (l.m_prev == null_bool_var) m_first = l.m_next; else m_links[l.m_prev].m_next = l.m_next;
+            if (l.m_next == null_bool_var) m_last = l.m_prev; else m_links[l.m_next].m_prev = l.m_prev;
+            l.m_prev = null_bool_var;
+            l.m_next = null_bool_var;
+        }
+
+        void enqueue(bool_var v) {
+            link & l = m_links[v];
+            l.m_prev  = m_last;
+            l.m_next  = null_bool_var;
+            l.m_stamp = ++m_stamp;
+            if (m_last == null_bool_var) m_first = v; else m_links[m_last].m_next = v;
+            m_last = v;
+        }
+
+    public:
+        vmtf_queue():m_first(null_bool_var), m_last(null_bool_var), m_search(null_bool_var), m_stamp(0) {}
+
+        void mk_var_eh(bool_var v) {
+            m_links.reserve(v+1);
+            m_links[v] = link();
+            enqueue(v);
+            m_search = v;
+        }
+
+        void del_var_eh(bool_var v) {
+            if (m_search == v)
+                m_search = m_links[v].m_prev;
+            dequeue(v);
+            m_bumped.reset(); // may contain v
+        }
+
+        void unassign_var_eh(bool_var v) {
+            if (m_search == null_bool_var || m_links[v].m_stamp > m_links[m_search].m_stamp)
+                m_search = v;
+        }
+
+        void bump(bool_var v) { m_bumped.push_back(v); }
+
+        /**
+           \brief Move the variables bumped since the last call to the end of the list,
+           preserving their relative order.
+        */
+        void move_bumped() {
+            if (m_bumped.empty())
+                return;
+            std::sort(m_bumped.begin(), m_bumped.end(), stamp_lt(m_links));
+            for (unsigned i = 0; i < m_bumped.size(); ++i) {
+                dequeue(m_bumped[i]);
+                enqueue(m_bumped[i]);
+            }
+            m_bumped.reset();
+            // bumped variables may be unassigned, next_var skips the assigned ones.
+            m_search = m_last;
+        }
+
+        void reset() {
+            m_links.reset();
+            m_bumped.reset();
+            m_first  = null_bool_var;
+            m_last   = null_bool_var;
+            m_search = null_bool_var;
+        }
+
+        bool empty() const { return m_search == null_bool_var; }
+
+        uint64 stamp(bool_var v) const { return m_links[v].m_stamp; }
+
+        bool_var peek_var() const { SASSERT(!empty()); return m_search; }
+
+        bool_var next_var() {
+            SASSERT(!empty());
+            bool_var v = m_search;
+            m_search = m_links[v].m_prev;
+            return v;
+        }
     };
 };
 
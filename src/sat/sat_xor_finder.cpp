@@ -0,0 +1,146 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    sat_xor_finder.cpp
+
+Abstract:
+
+    Find constraints of the form   x1 + ... + xn = p (mod 2)
+    encoded as clauses.
+
+Revision History:
+
+--*/
+#include"sat_xor_finder.h"
+#include"sat_solver.h"
+
+namespace sat {
+
+    bool xor_def_lt::operator()(xor_def const & x1, xor_def const & x2) const {
+        if (x1.m_vars.size() != x2.m_vars.size())
+            return x1.m_vars.size() < x2.m_vars.size();
+        for (unsigned i = 0; i < x1.m_vars.size(); ++i) {
+            if (x1.m_vars[i] != x2.m_vars[i])
+                return x1.m_vars[i] < x2.m_vars[i];
+        }
+        return x1.m_parity < x2.m_parity;
+    }
+
+    struct lit_var_lt {
+        bool operator()(literal l1, literal l2) const { return l1.var() < l2.var(); }
+    };
+
+    /**
+       \brief Order candidates by size, and then by their variables.
+    */
+    struct xor_finder::candidate_lt {
+        xor_finder const & f;
+        candidate_lt(xor_finder const & f):f(f) {}
+        bool operator()(unsigned c1, unsigned c2) const {
+            unsigned sz1 = f.get_size(c1), sz2 = f.get_size(c2);
+            if (sz1 != sz2)
+                return sz1 < sz2;
+            literal const * l1 = f.m_lits.c_ptr() + f.m_starts[c1];
+            literal const * l2 = f.m_lits.c_ptr() + f.m_starts[c2];
+            for (unsigned i = 0; i < sz1; ++i) {
+                if (l1[i].var() != l2[i].var())
+                    return l1[i].var() < l2[i].var();
+            }
+            return false;
+        }
+    };
+
+    xor_finder::xor_finder(solver & s, unsigned max_size):
+        s(s),
+        m_max_size(max_size) {
+        SASSERT(max_size <= 5); // the assignments of a candidate are stored in an unsigned bit-set
+    }
+
+    unsigned xor_finder::get_size(unsigned c) const {
+        return m_starts[c + 1] - m_starts[c];
+    }
+
+    /**
+       \brief The clause excludes the assignment where all its literals are false.
+       Bit i of the result is the value of the i-th variable in that assignment.
+    */
+    unsigned xor_finder::get_mask(unsigned c) const {
+        unsigned mask = 0;
+        for (unsigned i = m_starts[c], j = 0; i < m_starts[c + 1]; ++i, ++j) {
+            if (m_lits[i].sign())
+                mask |= (1u << j);
+        }
+        return mask;
+    }
+
+    void xor_finder::collect_candidates() {
+        m_lits.reset();
+        m_starts.reset();
+        clause_vector::const_iterator it  = s.m_clauses.begin();
+        clause_vector::const_iterator end = s.m_clauses.end();
+        for (; it != end; ++it) {
+            clause const & c = *(*it);
+            unsigned sz = c.size();
+            if (sz < 3 || sz > m_max_size || c.was_removed() || c.is_learned())
+                continue;
+            unsigned start = m_lits.size();
+            for (unsigned i = 0; i < sz; ++i)
+                m_lits.push_back(c[i]);
+            std::sort(m_lits.begin() + start, m_lits.end(), lit_var_lt());
+            bool ok = true;
+            for (unsigned i = start + 1; ok && i < m_lits.size(); ++i)
+                ok = m_lits[i - 1].var() != m_lits[i].var();
+            if (ok)
+                m_starts.push_back(start);
+            else
+                m_lits.shrink(start);
+        }
+        m_starts.push_back(m_lits.size());
+    }
+
+    void xor_finder::operator()(vector<xor_def> & xors) {
+        xors.reset();
+        collect_candidates();
+        unsigned_vector cs;
+        for (unsigned i = 0; i + 1 < m_starts.size(); ++i)
+            cs.push_back(i);
+        candidate_lt lt(*this);
+        std::sort(cs.begin(), cs.end(), lt);
+        unsigned i = 0;
+        while (i < cs.size()) {
+            unsigned j = i + 1;
+            while (j < cs.size() && !lt(cs[i], cs[j]))
+                ++j;
+            unsigned sz = get_size(cs[i]);
+            if (j - i >= (1u << (sz - 1))) {
+                // excluded[p] is the set of excluded assignments with parity p.
+                unsigned excluded[2] = { 0, 0 };
+                for (unsigned k = i; k < j; ++k) {
+                    unsigned mask = get_mask(cs[k]);
+                    excluded[get_num_1bits(mask) & 1] |= (1u << mask);
+                }
+                // parity 1 is tried first, such that the result is ordered by xor_def_lt.
+                for (unsigned p = 2; p-- > 0; ) {
+                    unsigned all = 0;
+                    for (unsigned mask = 0; mask < (1u << sz); ++mask) {
+                        if ((get_num_1bits(mask) & 1) == p)
+                            all |= (1u << mask);
+                    }
+                    if (excluded[p] != all)
+                        continue;
+                    // all assignments of parity p are excluded.
+                    xors.push_back(xor_def());
+                    xor_def & x = xors.back();
+                    for (unsigned k = m_starts[cs[i]]; k < m_starts[cs[i] + 1]; ++k)
+                        x.m_vars.push_back(m_lits[k].var());
+                    x.m_parity = p == 0;
+                }
+            }
+            i = j;
+        }
+        TRACE("sat_xor", tout << "found " << xors.size() << " xors\n";);
+    }
+
+};
@@ -0,0 +1,67 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    sat_xor_finder.h
+
+Abstract:
+
+    Find constraints of the form   x1 + ... + xn = p (mod 2)
+    That is, search for the 2^(n-1) clauses over x1, ..., xn
+    that exclude the assignments with the wrong parity.
+    For example, x1 + x2 + x3 = 1 is encoded by
+       x1 \/  x2 \/  x3
+       x1 \/ ~x2 \/ ~x3
+      ~x1 \/  x2 \/ ~x3
+      ~x1 \/ ~x2 \/  x3
+
+    The clauses are grouped by sorting them on their variables.
+
+Revision History:
+
+--*/
+#ifndef SAT_XOR_FINDER_H_
+#define SAT_XOR_FINDER_H_
+
+#include"sat_types.h"
+#include"vector.h"
+
+namespace sat {
+
+    /**
+       \brief XOR constraint m_vars[0] + ... + m_vars[n-1] = m_parity (mod 2).
+       The variables are sorted.
+    */
+    struct xor_def {
+        bool_var_vector m_vars;
+        bool            m_parity;
+    };
+
+    class xor_finder {
+        solver &          s;
+        unsigned          m_max_size;
+        literal_vector    m_lits;    // sorted literals of the candidate clauses
+        unsigned_vector   m_starts;  // start of each candidate in m_lits
+
+        struct candidate_lt;
+        void collect_candidates();
+        unsigned get_mask(unsigned c) const;
+        unsigned get_size(unsigned c) const;
+    public:
+        xor_finder(solver & s, unsigned max_size = 5);
+
+        /**
+           \brief Store in xors the XOR constraints encoded by the non-learned clauses.
+           The result is sorted by xor_def_lt.
+        */
+        void operator()(vector<xor_def> & xors);
+    };
+
+    struct xor_def_lt {
+        bool operator()(xor_def const & x1, xor_def const & x2) const;
+    };
+
+};
+
+#endif
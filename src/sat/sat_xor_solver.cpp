@@ -0,0 +1,427 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    sat_xor_solver.cpp
+
+Abstract:
+
+    Gauss-Jordan elimination for XOR constraints.
+
+Revision History:
+
+--*/
+#include"sat_xor_solver.h"
+#include"sat_solver.h"
+#include"bit_util.h"
+
+namespace sat {
+
+    static const unsigned null_col = UINT_MAX;
+
+    void xor_solver::matrix::add_row(unsigned dst, unsigned src) {
+        unsigned * d = row(dst);
+        unsigned const * s = row(src);
+        for (unsigned i = 0; i < m_num_words; ++i)
+            d[i] ^= s[i];
+        m_parity[dst] = m_parity[dst] != m_parity[src];
+    }
+
+    xor_solver::xor_solver(solver & s):
+        s(s) {
+    }
+
+    xor_solver::~xor_solver() {
+        std::for_each(m_matrices.begin(), m_matrices.end(), delete_proc<matrix>());
+    }
+
+    lbool xor_solver::value(matrix const & M, unsigned c) const {
+        return s.value(M.m_vars[c]);
+    }
+
+    /**
+       \brief Return an unassigned column of row r different from except, or null_col.
+    */
+    unsigned xor_solver::find_unassigned(matrix const & M, unsigned r, unsigned except) const {
+        unsigned const * bits = M.row(r);
+        for (unsigned i = 0; i < M.m_num_words; ++i) {
+            for (unsigned w = bits[i]; w != 0; w &= w - 1) {
+                unsigned c = 32 * i + ntz_core(w);
+                if (c != except && value(M, c) == l_undef)
+                    return c;
+            }
+        }
+        return null_col;
+    }
+
+    /**
+       \brief Return the column of row r, different from except, that was assigned at the highest level.
+    */
+    unsigned xor_solver::find_max_lvl(matrix const & M, unsigned r, unsigned except) const {
+        unsigned const * bits = M.row(r);
+        unsigned result = null_col;
+        for (unsigned i = 0; i < M.m_num_words; ++i) {
+            for (unsigned w = bits[i]; w != 0; w &= w - 1) {
+                unsigned c = 32 * i + ntz_core(w);
+                if (c != except && (result == null_col || s.lvl(M.m_vars[c]) > s.lvl(M.m_vars[result])))
+                    result = c;
+            }
+        }
+        return result;
+    }
+
+    void xor_solver::watch(matrix & M, unsigned c, unsigned r) {
+        M.m_watches[c].push_back(r);
+    }
+
+    void xor_solver::unwatch(matrix & M, unsigned c, unsigned r) {
+        unsigned_vector & ws = M.m_watches[c];
+        for (unsigned i = 0; i < ws.size(); ++i) {
+            if (ws[i] == r) {
+                ws[i] = ws.back();
+                ws.pop_back();
+                return;
+            }
+        }
+    }
+
+    void xor_solver::set_watch(matrix & M, unsigned r, unsigned c) {
+        unsigned old_c = M.m_watch[r];
+        if (old_c == c)
+            return;
+        SASSERT(c != M.m_pivot[r]);
+        if (old_c != null_col)
+            unwatch(M, old_c, r);
+        M.m_watch[r] = c;
+        if (c != null_col)
+            watch(M, c, r);
+    }
+
+    /**
+       \brief Make c the basic column of row r, and eliminate it from the other rows.
+       The modified rows are scheduled to be checked.
+    */
+    void xor_solver::set_pivot(matrix & M, unsigned r, unsigned c) {
+        unsigned old_c = M.m_pivot[r];
+        SASSERT(M.get(r, c) && c != old_c);
+        for (unsigned j = 0; j < M.num_rows(); ++j) {
+            if (j != r && M.get(j, c)) {
+                M.add_row(j, r);
+                m_todo.push_back(j);
+                m_stats.m_num_eliminations++;
+            }
+        }
+        unwatch(M, old_c, r);
+        if (M.m_watch[r] == c)
+            M.m_watch[r] = null_col; // the watch on c is kept for the basic column
+        else
+            watch(M, c, r);
+        M.m_pivot[r] = c;
+    }
+
+    /**
+       \brief Save the literals of row r, other than the one of column except, that are true.
+    */
+    unsigned xor_solver::mk_reason(matrix const & M, unsigned r, unsigned except) {
+        unsigned idx = m_reasons.size();
+        m_reasons.push_back(m_antecedents.size());
+        unsigned const * bits = M.row(r);
+        for (unsigned i = 0; i < M.m_num_words; ++i) {
+            for (unsigned w = bits[i]; w != 0; w &= w - 1) {
+                unsigned c = 32 * i + ntz_core(w);
+                if (c == except)
+                    continue;
+                SASSERT(value(M, c) != l_undef);
+                m_antecedents.push_back(literal(M.m_vars[c], value(M, c) == l_false));
+            }
+        }
+        return idx;
+    }
+
+    void xor_solver::check_row(matrix & M, unsigned r) {
+        unsigned p = M.m_pivot[r];
+        if (value(M, p) != l_undef) {
+            unsigned c = find_unassigned(M, r, p);
+            if (c != null_col) {
+                set_pivot(M, r, c);
+                p = c;
+            }
+        }
+        unsigned w = M.m_watch[r];
+        if (w == null_col || !M.get(r, w) || value(M, w) != l_undef)
+            w = find_unassigned(M, r, p);
+        if (w != null_col) {
+            set_watch(M, r, w);
+            return;
+        }
+        // all non-basic variables are assigned.
+        // watch the last assigned one, such that the row is checked again after backtracking.
+        set_watch(M, r, find_max_lvl(M, r, p));
+        bool parity = M.m_parity[r];
+        unsigned const * bits = M.row(r);
+        for (unsigned i = 0; i < M.m_num_words; ++i) {
+            for (unsigned w = bits[i]; w != 0; w &= w - 1) {
+                unsigned c = 32 * i + ntz_core(w);
+                if (c != p && value(M, c) == l_true)
+                    parity = !parity;
+            }
+        }
+        literal lit(M.m_vars[p], !parity);
+        switch (s.value(lit)) {
+        case l_true:
+            break;
+        case l_undef:
+            TRACE("sat_xor", tout << "propagate " << lit << "\n";);
+            m_stats.m_num_propagations++;
+            s.assign(lit, justification::mk_ext_justification(mk_reason(M, r, p)));
+            break;
+        case l_false:
+            TRACE("sat_xor", tout << "conflict " << lit << "\n";);
+            m_stats.m_num_conflicts++;
+            s.set_conflict(justification::mk_ext_justification(mk_reason(M, r, null_col)));
+            break;
+        }
+    }
+
+    void xor_solver::check_rows(matrix & M) {
+        for (unsigned i = 0; i < m_todo.size() && !s.inconsistent(); ++i)
+            check_row(M, m_todo[i]);
+        m_todo.reset();
+    }
+
+    void xor_solver::propagate(literal l, ext_constraint_idx idx, bool & keep) {
+        keep = true;
+        matrix & M = *m_matrices[idx];
+        unsigned c = m_var2col[l.var()];
+        m_todo.reset();
+        m_todo.append(M.m_watches[c]);
+        check_rows(M);
+    }
+
+    void xor_solver::get_antecedents(literal l, ext_justification_idx idx, literal_vector & r) {
+        unsigned end = idx + 1 < m_reasons.size() ? m_reasons[idx + 1] : m_antecedents.size();
+        for (unsigned i = m_reasons[idx]; i < end; ++i)
+            r.push_back(m_antecedents[i]);
+    }
+
+    check_result xor_solver::check() {
+        for (unsigned i = 0; i < m_matrices.size() && !s.inconsistent(); ++i) {
+            matrix & M = *m_matrices[i];
+            for (unsigned r = 0; r < M.num_rows(); ++r)
+                m_todo.push_back(r);
+            check_rows(M);
+        }
+        return s.inconsistent() ? CR_CONTINUE : CR_DONE;
+    }
+
+    void xor_solver::push() {
+        m_scopes.push_back(m_reasons.size());
+    }
+
+    void xor_solver::pop(unsigned n) {
+        SASSERT(n <= m_scopes.size());
+        unsigned lim = m_scopes[m_scopes.size() - n];
+        m_scopes.shrink(m_scopes.size() - n);
+        if (lim < m_reasons.size()) {
+            m_antecedents.shrink(m_reasons[lim]);
+            m_reasons.shrink(lim);
+        }
+    }
+
+    void xor_solver::reset_matrices() {
+        for (unsigned i = 0; i < m_matrices.size(); ++i) {
+            matrix const & M = *m_matrices[i];
+            for (unsigned j = 0; j < M.num_cols(); ++j) {
+                bool_var v = M.m_vars[j];
+                m_var2matrix[v] = UINT_MAX;
+                if (v >= s.num_vars())
+                    continue;
+                for (unsigned sign = 0; sign < 2; ++sign) {
+                    watch_list & wlist = s.get_wlist(literal(v, sign != 0));
+                    watch_list::iterator it  = wlist.begin();
+                    watch_list::iterator it2 = it;
+                    watch_list::iterator end = wlist.end();
+                    for (; it != end; ++it) {
+                        if (!it->is_ext_constraint()) {
+                            *it2 = *it;
+                            ++it2;
+                        }
+                    }
+                    wlist.set_end(it2);
+                }
+            }
+            dealloc(m_matrices[i]);
+        }
+        m_matrices.reset();
+    }
+
+    static unsigned find_root(unsigned_vector & parent, unsigned v) {
+        while (parent[v] != v) {
+            parent[v] = parent[parent[v]];
+            v = parent[v];
+        }
+        return v;
+    }
+
+    /**
+       \brief Create a matrix for every independent system of XOR constraints.
+    */
+    void xor_solver::init_matrices() {
+        reset_matrices();
+        unsigned num_vars = s.num_vars();
+        m_var2matrix.resize(num_vars, UINT_MAX);
+        m_var2col.resize(num_vars, 0);
+        unsigned_vector parent;
+        for (unsigned v = 0; v < num_vars; ++v)
+            parent.push_back(v);
+        for (unsigned i = 0; i < m_xors.size(); ++i) {
+            bool_var_vector const & vars = m_xors[i].m_vars;
+            unsigned r = find_root(parent, vars[0]);
+            for (unsigned j = 1; j < vars.size(); ++j) {
+                unsigned r2 = find_root(parent, vars[j]);
+                parent[r2] = r;
+            }
+        }
+        // group the XOR constraints by their root variable.
+        vector<unsigned_vector> systems;
+        unsigned_vector root2system;
+        root2system.resize(num_vars, UINT_MAX);
+        for (unsigned i = 0; i < m_xors.size(); ++i) {
+            unsigned r = find_root(parent, m_xors[i].m_vars[0]);
+            if (root2system[r] == UINT_MAX) {
+                root2system[r] = systems.size();
+                systems.push_back(unsigned_vector());
+            }
+            systems[root2system[r]].push_back(i);
+        }
+        for (unsigned i = 0; i < systems.size() && !s.inconsistent(); ++i) {
+            // a single XOR constraint is propagated as well by its clauses.
+            if (systems[i].size() > 1 && systems[i].size() <= s.m_config.m_xor_solver_max_rows)
+                mk_matrix(systems[i]);
+        }
+        m_stats.m_num_matrices = m_matrices.size();
+        IF_VERBOSE(2, verbose_stream() << "(sat-xor :xors " << m_xors.size() << " :matrices " << m_matrices.size() << ")\n";);
+    }
+
+    void xor_solver::mk_matrix(unsigned_vector const & xors) {
+        unsigned id = m_matrices.size();
+        matrix * M = alloc(matrix);
+        m_matrices.push_back(M);
+        for (unsigned i = 0; i < xors.size(); ++i) {
+            bool_var_vector const & vars = m_xors[xors[i]].m_vars;
+            for (unsigned j = 0; j < vars.size(); ++j) {
+                bool_var v = vars[j];
+                if (m_var2matrix[v] != id) {
+                    m_var2matrix[v] = id;
+                    m_var2col[v] = M->m_vars.size();
+                    M->m_vars.push_back(v);
+                    s.m_external[v] = true;
+                }
+            }
+        }
+        M->m_num_words = (M->num_cols() + 31) / 32;
+        M->m_watches.resize(M->num_cols());
+        // add the rows one by one, keeping the matrix in reduced row echelon form.
+        for (unsigned i = 0; i < xors.size(); ++i) {
+            xor_def const & x = m_xors[xors[i]];
+            unsigned r = M->num_rows();
+            M->m_bits.resize(M->m_bits.size() + M->m_num_words, 0);
+            M->m_parity.push_back(x.m_parity);
+            M->m_pivot.push_back(null_col);
+            unsigned * bits = M->row(r);
+            for (unsigned j = 0; j < x.m_vars.size(); ++j) {
+                unsigned c = m_var2col[x.m_vars[j]];
+                bits[c / 32] |= (1u << (c % 32));
+            }
+            for (unsigned j = 0; j < r; ++j) {
+                if (M->get(r, M->m_pivot[j]))
+                    M->add_row(r, j);
+            }
+            unsigned p = find_unassigned(*M, r, null_col);
+            if (p == null_col)
+                p = find_max_lvl(*M, r, null_col);
+            if (p == null_col) {
+                // the constraint is implied by the previous ones.
+                if (M->m_parity[r])
+                    s.set_conflict(justification());
+                M->m_bits.shrink(M->m_bits.size() - M->m_num_words);
+                M->m_parity.pop_back();
+                M->m_pivot.pop_back();
+                continue;
+            }
+            M->m_pivot[r] = p;
+            for (unsigned j = 0; j < r; ++j) {
+                if (M->get(j, p))
+                    M->add_row(j, r);
+            }
+        }
+        M->m_watch.resize(M->num_rows(), null_col);
+        for (unsigned r = 0; r < M->num_rows(); ++r) {
+            watch(*M, M->m_pivot[r], r);
+            m_todo.push_back(r);
+        }
+        for (unsigned i = 0; i < M->num_cols(); ++i) {
+            bool_var v = M->m_vars[i];
+            s.get_wlist(literal(v, false)).push_back(watched(id));
+            s.get_wlist(literal(v, true)).push_back(watched(id));
+        }
+        if (s.inconsistent())
+            m_todo.reset();
+        else
+            check_rows(*M);
+    }
+
+    void xor_solver::find_xors() {
+        SASSERT(s.scope_lvl() == 0);
+        if (s.inconsistent())
+            return;
+        vector<xor_def> xors;
+        xor_finder find(s);
+        find(xors);
+        // merge the new XOR constraints with the known ones.
+        vector<xor_def> result;
+        xor_def_lt lt;
+        unsigned i = 0, j = 0;
+        while (i < m_xors.size() || j < xors.size()) {
+            if (j == xors.size() || (i < m_xors.size() && lt(m_xors[i], xors[j])))
+                result.push_back(m_xors[i++]);
+            else if (i == m_xors.size() || lt(xors[j], m_xors[i]))
+                result.push_back(xors[j++]);
+            else {
+                result.push_back(m_xors[i++]);
+                ++j;
+            }
+        }
+        if (result.size() == m_xors.size())
+            return;
+        m_xors.swap(result);
+        m_stats.m_num_xors = m_xors.size();
+        init_matrices();
+    }
+
+    void xor_solver::gc_vars(bool_var v) {
+        unsigned j = 0;
+        for (unsigned i = 0; i < m_xors.size(); ++i) {
+            if (m_xors[i].m_vars.back() < v) {
+                if (i != j)
+                    m_xors[j] = m_xors[i];
+                ++j;
+            }
+        }
+        if (j == m_xors.size())
+            return;
+        m_xors.shrink(j);
+        m_stats.m_num_xors = m_xors.size();
+        init_matrices();
+    }
+
+    void xor_solver::collect_statistics(statistics & st) const {
+        st.update("xor constraints", m_stats.m_num_xors);
+        st.update("xor matrices", m_stats.m_num_matrices);
+        st.update("xor propagations", m_stats.m_num_propagations);
+        st.update("xor conflicts", m_stats.m_num_conflicts);
+        st.update("xor eliminations", m_stats.m_num_eliminations);
+    }
+
+};
@@ -0,0 +1,124 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    sat_xor_solver.h
+
+Abstract:
+
+    Gauss-Jordan elimination for XOR constraints.
+
+    The XOR constraints found by xor_finder are partitioned into
+    independent systems. Each system is kept in reduced row echelon
+    form in a bit-packed matrix: every row has a basic column that
+    does not occur in the other rows, and watches one unassigned
+    non-basic column.
+
+    When the basic variable of a row is assigned, another unassigned
+    column of the row becomes basic and is eliminated from the other
+    rows. When all non-basic variables of a row are assigned, the
+    basic variable is propagated, or a conflict is reported.
+
+    The rows are linear combinations of the XOR constraints, so the
+    matrix is not restored when backtracking. The antecedents of
+    propagations are saved, since the rows keep changing.
+
+Revision History:
+
+--*/
+#ifndef SAT_XOR_SOLVER_H_
+#define SAT_XOR_SOLVER_H_
+
+#include"sat_extension.h"
+#include"sat_xor_finder.h"
+#include"statistics.h"
+
+namespace sat {
+
+    class xor_solver : public extension {
+        struct stats {
+            unsigned m_num_xors;
+            unsigned m_num_matrices;
+            unsigned m_num_propagations;
+            unsigned m_num_conflicts;
+            unsigned m_num_eliminations;
+            stats() { reset(); }
+            void reset() { memset(this, 0, sizeof(*this)); }
+        };
+
+        struct matrix {
+            bool_var_vector         m_vars;      // column -> variable
+            unsigned                m_num_words; // words per row
+            unsigned_vector         m_bits;      // bit-packed rows
+            svector<bool>           m_parity;    // row -> right-hand side
+            unsigned_vector         m_pivot;     // row -> basic column
+            unsigned_vector         m_watch;     // row -> watched non-basic column
+            vector<unsigned_vector> m_watches;   // column -> rows where it is basic or watched
+
+            unsigned num_rows() const { return m_pivot.size(); }
+            unsigned num_cols() const { return m_vars.size(); }
+            unsigned * row(unsigned r) { return m_bits.c_ptr() + r * m_num_words; }
+            unsigned const * row(unsigned r) const { return m_bits.c_ptr() + r * m_num_words; }
+            bool get(unsigned r, unsigned c) const { return (row(r)[c / 32] & (1u << (c % 32))) != 0; }
+            void add_row(unsigned dst, unsigned src);
+        };
+
+        solver &                s;
+        stats                   m_stats;
+        vector<xor_def>         m_xors;
+        ptr_vector<matrix>      m_matrices;
+        unsigned_vector         m_var2matrix;
+        unsigned_vector         m_var2col;
+        unsigned_vector         m_todo;        // rows to be checked
+        literal_vector          m_antecedents;
+        unsigned_vector         m_reasons;     // reason -> first antecedent
+        unsigned_vector         m_scopes;      // number of reasons per scope
+
+        lbool value(matrix const & M, unsigned c) const;
+        void reset_matrices();
+        void init_matrices();
+        void mk_matrix(unsigned_vector const & xors);
+        unsigned find_unassigned(matrix const & M, unsigned r, unsigned except) const;
+        unsigned find_max_lvl(matrix const & M, unsigned r, unsigned except) const;
+        void watch(matrix & M, unsigned c, unsigned r);
+        void unwatch(matrix & M, unsigned c, unsigned r);
+        void set_watch(matrix & M, unsigned r, unsigned c);
+        void set_pivot(matrix & M, unsigned r, unsigned c);
+        unsigned mk_reason(matrix const & M, unsigned r, unsigned except);
+        void check_row(matrix & M, unsigned r);
+        void check_rows(matrix & M);
+
+    public:
+        xor_solver(solver & s);
+        virtual ~xor_solver();
+
+        virtual void propagate(literal l, ext_constraint_idx idx, bool & keep);
+        virtual void get_antecedents(literal l, ext_justification_idx idx, literal_vector & r);
+        virtual void asserted(literal l) {}
+        virtual check_result check();
+        virtual void push();
+        virtual void pop(unsigned n);
+        virtual void simplify() {}
+        virtual void clauses_modifed() {}
+        virtual lbool get_phase(bool_var v) { return l_undef; }
+
+        /**
+           \brief Add the XOR constraints encoded by the clauses.
+           The variables of the XOR constraints become external, so they are not eliminated.
+           \pre base level.
+        */
+        void find_xors();
+
+        /**
+           \brief Remove the XOR constraints over variables v and higher.
+        */
+        void gc_vars(bool_var v);
+
+        void collect_statistics(statistics & st) const;
+        void reset_statistics() { m_stats.reset(); }
+    };
+
+};
+
+#endif
@@ -36,6 +36,7 @@ Notes:
 #include"model_v2_pp.h"
 #include"tactic.h"
 #include"ast_pp.h"
+#include"pb_decl_plugin.h"
 #include<sstream>
 
 struct goal2sat::imp {
@@ -48,11 +49,13 @@ struct goal2sat::imp {
             m_t(t), m_root(r), m_sign(s), m_idx(idx) {}
     };
     ast_manager &               m;
+    pb_util                     pb;
     svector<frame>              m_frame_stack;
     svector<sat::literal>       m_result_stack;
     obj_map<app, sat::literal>  m_cache;
     obj_hashtable<expr>         m_interface_vars;
     sat::solver &               m_solver;
+    sat::card_solver *          m_card;
     atom2bool_var &             m_map;
     dep2asm_map &               m_dep2asm;
     sat::bool_var               m_true;
@@ -63,7 +66,9 @@ struct goal2sat::imp {
     
     imp(ast_manager & _m, params_ref const & p, sat::solver & s, atom2bool_var & map, dep2asm_map& dep2asm, bool default_external):
         m(_m),
+        pb(_m),
         m_solver(s),
+        m_card(s.get_card_solver()),
         m_map(map),
         m_dep2asm(dep2asm),
         m_trail(m),
@@ -162,6 +167,10 @@ struct goal2sat::imp {
         }
         if (process_cached(to_app(t), root, sign))
             return true;
+        if (is_native_pb(t)) {
+            m_frame_stack.push_back(frame(to_app(t), root, sign, 0));
+            return false;
+        }
         if (to_app(t)->get_family_id() != m.get_basic_family_id()) {
             convert_atom(t, root, sign);
             return true;
@@ -305,7 +314,109 @@ struct goal2sat::imp {
         }
     }
 
+    /**
+       \brief Return true if t is a cardinality or pseudo-Boolean constraint
+       that is passed to the cardinality solver of the SAT solver.
+    */
+    bool is_native_pb(expr * t) const {
+        return
+            m_card &&
+            (pb.is_at_most_k(t) || pb.is_at_least_k(t) || pb.is_le(t) || pb.is_ge(t) || pb.is_eq(t)) &&
+            pb.has_unsigned_coefficients(t);
+    }
+
+    struct pb_constraint {
+        sat::literal_vector m_lits;
+        unsigned_vector     m_coeffs;
+        unsigned            m_k;
+    };
+
+    /**
+       \brief Store in c the constraint  c_1*~l_1 + ... + c_n*~l_n >= c_1 + ... + c_n - k + 1,
+       that is the negation of  c_1*l_1 + ... + c_n*l_n >= k.
+    */
+    void mk_negation(pb_constraint const & c, pb_constraint & r) {
+        unsigned sum = 0;
+        for (unsigned i = 0; i < c.m_lits.size(); ++i) {
+            r.m_lits.push_back(~c.m_lits[i]);
+            r.m_coeffs.push_back(c.m_coeffs[i]);
+            sum += c.m_coeffs[i];
+        }
+        r.m_k = c.m_k <= sum ? sum - c.m_k + 1 : 0;
+    }
+
+    sat::literal mk_pb_ge(pb_constraint const & c) {
+        sat::literal l(m_solver.mk_var(), false);
+        m_card->add_pb_ge(l, c.m_lits.size(), c.m_lits.c_ptr(), c.m_coeffs.c_ptr(), c.m_k);
+        return l;
+    }
+
+    void convert_pb(app * t, bool root, bool sign) {
+        TRACE("goal2sat", tout << "convert_pb " << root << " " << sign << "\n" << mk_ismt2_pp(t, m) << "\n";);
+        unsigned num = t->get_num_args();
+        unsigned sz  = m_result_stack.size();
+        SASSERT(num <= sz);
+        // the constraint is a conjunction of one or two constraints of the form  c_1*l_1 + ... + c_n*l_n >= k
+        pb_constraint cs[2];
+        unsigned num_cs = pb.is_eq(t) ? 2 : 1;
+        unsigned k = pb.get_k(t).get_unsigned();
+        unsigned sum = 0;
+        for (unsigned i = 0; i < num; ++i) {
+            sat::literal l = m_result_stack[sz - num + i];
+            unsigned c = pb.get_coeff(t, i).get_unsigned();
+            sum += c;
+            if (pb.is_at_most_k(t) || pb.is_le(t)) {
+                cs[0].m_lits.push_back(~l);
+            }
+            else {
+                cs[0].m_lits.push_back(l);
+                cs[1].m_lits.push_back(~l);
+            }
+            cs[0].m_coeffs.push_back(c);
+            cs[1].m_coeffs.push_back(c);
+        }
+        m_result_stack.shrink(sz - num);
+        if (pb.is_at_most_k(t) || pb.is_le(t)) {
+            cs[0].m_k = k <= sum ? sum - k : 0;
+        }
+        else {
+            cs[0].m_k = k;
+            cs[1].m_k = k <= sum ? sum - k : 0;
+        }
+        if (root && !sign) {
+            for (unsigned i = 0; i < num_cs; ++i)
+                m_card->add_pb_ge(sat::null_literal, cs[i].m_lits.size(), cs[i].m_lits.c_ptr(), cs[i].m_coeffs.c_ptr(), cs[i].m_k);
+            return;
+        }
+        if (root && num_cs == 1) {
+            pb_constraint r;
+            mk_negation(cs[0], r);
+            m_card->add_pb_ge(sat::null_literal, r.m_lits.size(), r.m_lits.c_ptr(), r.m_coeffs.c_ptr(), r.m_k);
+            return;
+        }
+        sat::literal l = mk_pb_ge(cs[0]);
+        if (num_cs == 2) {
+            // l <=> l1 and l2
+            sat::literal l1 = l, l2 = mk_pb_ge(cs[1]);
+            l = sat::literal(m_solver.mk_var(), false);
+            mk_clause(~l, l1);
+            mk_clause(~l, l2);
+            mk_clause(l, ~l1, ~l2);
+        }
+        m_cache.insert(t, l);
+        if (sign)
+            l.neg();
+        if (root)
+            mk_clause(l);
+        else
+            m_result_stack.push_back(l);
+    }
+
     void convert(app * t, bool root, bool sign) {
+        if (t->get_family_id() == pb.get_family_id()) {
+            convert_pb(t, root, sign);
+            return;
+        }
         SASSERT(t->get_family_id() == m.get_basic_family_id());
         switch (to_app(t)->get_decl_kind()) {
         case OP_OR:
@@ -711,6 +822,26 @@ struct sat2goal::imp {
         assert_clauses(s.begin_clauses(), s.end_clauses(), r);
         if (m_learned)
             assert_clauses(s.begin_learned(), s.end_learned(), r);
+        // collect cardinality and pseudo-Boolean constraints
+        if (s.get_card_solver())
+            assert_pb_constraints(*s.get_card_solver(), r);
+    }
+
+    void assert_pb_constraints(sat::card_solver const & card, goal & r) {
+        pb_util pb(m);
+        ptr_buffer<expr> lits;
+        vector<rational> coeffs;
+        for (unsigned idx = 0; idx < card.num_constraints(); ++idx) {
+            checkpoint();
+            lits.reset();
+            coeffs.reset();
+            for (unsigned i = 0; i < card.get_size(idx); ++i) {
+                lits.push_back(lit2expr(card.get_lit(idx, i)));
+                coeffs.push_back(rational(card.get_coeff(idx, i), rational::ui64()));
+            }
+            rational k(card.get_k(idx), rational::ui64());
+            r.assert_expr(pb.mk_ge(lits.size(), coeffs.c_ptr(), lits.c_ptr(), k));
+        }
     }
 
 };
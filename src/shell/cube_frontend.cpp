@@ -0,0 +1,189 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    cube_frontend.cpp
+
+Abstract:
+
+    Cube and conquer on a pool of processes.
+
+    The assertions of an SMT 2.0 benchmark are split by the cubes
+    returned by solver::cube. The negation of each cube is asserted
+    before the next cube is retrieved, so the cubes partition the
+    problem. Each cube is solved by a forked worker process that
+    inherits the solver of the driver, and the worker reports its
+    result through its exit status.
+
+Revision History:
+
+--*/
+#include<iostream>
+#include<fstream>
+#include"cmd_context.h"
+#include"smt2parser.h"
+#include"smt_strategic_solver.h"
+#include"error_codes.h"
+#include"timer.h"
+#include"cube_frontend.h"
+#ifndef _WINDOWS
+#include<sys/types.h>
+#include<sys/wait.h>
+#include<signal.h>
+#include<unistd.h>
+#endif
+
+extern bool g_display_statistics;
+
+#ifndef _WINDOWS
+
+// exit status of the workers.
+static const int CUBE_SAT   = 10;
+static const int CUBE_UNSAT = 20;
+
+/**
+   \brief Solve the assertions of s together with the cube in a new process.
+   Return the process id of the worker, or -1 if it could not be created.
+*/
+static pid_t spawn_worker(solver & s, expr * cube) {
+    std::cout.flush();
+    std::cerr.flush();
+    pid_t pid = fork();
+    if (pid != 0)
+        return pid;
+    int status = 0;
+    try {
+        s.assert_expr(cube);
+        switch (s.check_sat(0, 0)) {
+        case l_true:  status = CUBE_SAT; break;
+        case l_false: status = CUBE_UNSAT; break;
+        default: break;
+        }
+    }
+    catch (z3_exception & ex) {
+        IF_VERBOSE(1, verbose_stream() << "(cube :worker-error \"" << ex.msg() << "\")\n";);
+    }
+    _exit(status);
+}
+
+/**
+   \brief Wait for one of the workers to finish and remove it from the pool.
+*/
+static lbool wait_worker(svector<pid_t> & workers) {
+    int status = 0;
+    pid_t pid = waitpid(-1, &status, 0);
+    if (pid < 0) {
+        workers.reset();
+        return l_undef;
+    }
+    workers.erase(pid);
+    if (WIFEXITED(status)) {
+        switch (WEXITSTATUS(status)) {
+        case CUBE_SAT:   return l_true;
+        case CUBE_UNSAT: return l_false;
+        default: break;
+        }
+    }
+    return l_undef;
+}
+
+static lbool solve_cubes(solver & s, unsigned num_workers, unsigned depth, unsigned & num_cubes) {
+    ast_manager & m = s.get_manager();
+    svector<pid_t> workers;
+    lbool result = l_false;
+    try {
+        while (result != l_true) {
+            expr_ref cube = s.cube(depth);
+            if (m.is_false(cube))
+                break;
+            while (workers.size() >= num_workers && result != l_true) {
+                lbool r = wait_worker(workers);
+                if (r != l_false)
+                    result = r;
+            }
+            if (result == l_true)
+                break;
+            pid_t pid = spawn_worker(s, cube);
+            if (pid < 0) {
+                result = l_undef;
+                break;
+            }
+            workers.push_back(pid);
+            ++num_cubes;
+            IF_VERBOSE(2, verbose_stream() << "(cube :index " << num_cubes << " :size "
+                       << (m.is_and(cube) ? to_app(cube)->get_num_args() : (m.is_true(cube) ? 0 : 1)) << ")\n";);
+            if (m.is_true(cube))
+                break;
+            s.assert_expr(m.mk_not(cube));
+        }
+    }
+    catch (z3_exception & ex) {
+        std::cerr << "(error \"" << ex.msg() << "\")" << std::endl;
+        result = l_undef;
+    }
+    if (result == l_true) {
+        for (unsigned i = 0; i < workers.size(); ++i)
+            kill(workers[i], SIGKILL);
+    }
+    while (!workers.empty()) {
+        lbool r = wait_worker(workers);
+        if (result == l_false && r != l_false)
+            result = r;
+    }
+    return result;
+}
+
+unsigned solve_cubes(char const * file_name, unsigned num_workers, unsigned depth) {
+    timer t;
+    cmd_context ctx;
+    ctx.set_solver_factory(mk_smt_strategic_solver_factory());
+    // the check-sat commands are replaced by the cube and conquer loop.
+    ctx.set_ignore_check(true);
+    bool ok = true;
+    if (file_name) {
+        std::ifstream in(file_name);
+        if (in.bad() || in.fail()) {
+            std::cerr << "(error \"failed to open file '" << file_name << "'\")" << std::endl;
+            exit(ERR_OPEN_FILE);
+        }
+        ok = parse_smt2_commands(ctx, in);
+    }
+    else {
+        ok = parse_smt2_commands(ctx, std::cin, true);
+    }
+    if (!ok)
+        return 1;
+
+    ast_manager & m = ctx.m();
+    params_ref p;
+    bool proofs_enabled, models_enabled, unsat_core_enabled;
+    ctx.params().get_solver_params(m, p, proofs_enabled, models_enabled, unsat_core_enabled);
+    ref<solver> s = ctx.get_solver_factory()(m, p, false, models_enabled, false, ctx.get_logic());
+    ptr_vector<expr>::const_iterator it  = ctx.begin_assertions();
+    ptr_vector<expr>::const_iterator end = ctx.end_assertions();
+    for (; it != end; ++it)
+        s->assert_expr(*it);
+
+    unsigned num_cubes = 0;
+    lbool r = solve_cubes(*s, num_workers, depth, num_cubes);
+    switch (r) {
+    case l_true:  std::cout << "sat" << std::endl; break;
+    case l_false: std::cout << "unsat" << std::endl; break;
+    default:      std::cout << "unknown" << std::endl; break;
+    }
+    if (g_display_statistics) {
+        std::cout << "(:cubes " << num_cubes << " :workers " << num_workers << " :depth " << depth
+                  << " :time " << t.get_seconds() << ")" << std::endl;
+    }
+    return 0;
+}
+
+#else
+
+unsigned solve_cubes(char const * file_name, unsigned num_workers, unsigned depth) {
+    std::cerr << "(error \"cube and conquer using processes is not supported on this platform\")" << std::endl;
+    return ERR_NOT_IMPLEMENTED_YET;
+}
+
+#endif
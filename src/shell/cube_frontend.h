@@ -0,0 +1,20 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    cube_frontend.h
+
+Abstract:
+
+    Cube and conquer on a pool of processes.
+
+Revision History:
+
+--*/
+#ifndef CUBE_FRONTEND_H_
+#define CUBE_FRONTEND_H_
+
+unsigned solve_cubes(char const * file_name, unsigned num_workers, unsigned depth);
+
+#endif /* CUBE_FRONTEND_H_ */
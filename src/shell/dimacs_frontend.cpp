@@ -152,7 +152,11 @@ unsigned read_dimacs(char const * file_name) {
     
     lbool r;
     vector<sat::literal_vector> tracking_clauses;
-    sat::solver solver2(p, limit, 0);
+    // the solver used for core extraction checks under assumptions,
+    // so it does not produce a DRAT proof.
+    params_ref p2(p);
+    p2.set_sym("drat.file", symbol(""));
+    sat::solver solver2(p2, limit, 0);
     if (p.get_bool("dimacs.core", false)) {
         g_solver = &solver2;        
         sat::literal_vector assumptions;
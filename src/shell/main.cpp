@@ -30,6 +30,7 @@ Revision History:
 #include"dimacs_frontend.h"
 #include"datalog_frontend.h"
 #include"opt_frontend.h"
+#include"cube_frontend.h"
 #include"timeout.h"
 #include"z3_exception.h"
 #include"error_codes.h"
@@ -44,6 +45,8 @@ bool                g_standard_input      = false;
 input_kind          g_input_kind          = IN_UNSPECIFIED;
 bool                g_display_statistics  = false;
 bool                g_display_istatistics = false;
+unsigned            g_cube_workers        = 0;
+unsigned            g_cube_depth          = 6;
 
 void error(const char * msg) {
     std::cerr << "Error: " << msg << "\n";
@@ -93,6 +96,9 @@ void display_usage() {
     // 
     std::cout << "\nOutput:\n";
     std::cout << "  -st         display statistics.\n";
+    std::cout << "\nCube and conquer:\n";
+    std::cout << "  -cube:workers      split the SMT 2 problem into cubes and solve them using <workers> processes.\n";
+    std::cout << "  -cube_depth:depth  maximal number of literals in a cube (default: 6).\n";
 #if defined(Z3DEBUG) || defined(_TRACE)
     std::cout << "\nDebugging support:\n";
 #endif
@@ -248,6 +254,19 @@ void parse_cmd_line_args(int argc, char ** argv) {
                 enable_debug(opt_arg);
             }
 #endif
+            else if (strcmp(opt_name, "cube") == 0) {
+                if (!opt_arg)
+                    error("option argument (-cube:workers) is missing.");
+                long workers = strtol(opt_arg, 0, 10);
+                if (workers <= 0)
+                    error("the number of workers must be positive.");
+                g_cube_workers = static_cast<unsigned>(workers);
+            }
+            else if (strcmp(opt_name, "cube_depth") == 0) {
+                if (!opt_arg)
+                    error("option argument (-cube_depth:depth) is missing.");
+                g_cube_depth = static_cast<unsigned>(strtol(opt_arg, 0, 10));
+            }
             else if (strcmp(opt_name, "memory") == 0) {
                 if (!opt_arg)
                     error("option argument (-memory:val) is missing.");
@@ -339,7 +358,10 @@ int STD_CALL main(int argc, char ** argv) {
             break;
         case IN_SMTLIB_2:
             memory::exit_when_out_of_memory(true, "(error \"out of memory\")");
-            return_value = read_smtlib2_commands(g_input_file);
+            if (g_cube_workers > 0)
+                return_value = solve_cubes(g_input_file, g_cube_workers, g_cube_depth);
+            else
+                return_value = read_smtlib2_commands(g_input_file);
             break;
         case IN_DIMACS:
             return_value = read_dimacs(g_input_file);
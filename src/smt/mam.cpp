@@ -1837,6 +1837,7 @@ namespace smt {
         ast_manager &       m_ast_manager;
         mam &               m_mam;
         bool                m_use_filters;
+        bool                m_profile; // qi.profile also needs the enodes used in a match
         enode_vector        m_registers;
         enode_vector        m_bindings;
         enode_vector        m_args;
@@ -1869,10 +1870,14 @@ namespace smt {
             m_pool.recycle(v);
         }
 
+        bool track_used_enodes() const {
+            return m_profile || m_ast_manager.has_trace_stream();
+        }
+
         void update_max_generation(enode * n) {
             m_max_generation = std::max(m_max_generation, n->get_generation());
 
-            if (m_ast_manager.has_trace_stream())
+            if (track_used_enodes())
                 m_used_enodes.push_back(n);
         }
         
@@ -1984,7 +1989,8 @@ namespace smt {
             m_context(ctx),
             m_ast_manager(ctx.get_manager()),
             m_mam(m), 
-            m_use_filters(use_filters) {
+            m_use_filters(use_filters),
+            m_profile(ctx.get_fparams().m_qi_profile) {
             m_args.resize(INIT_ARGS_SIZE, 0);
         }
 
@@ -2281,7 +2287,7 @@ namespace smt {
         m_pattern_instances.push_back(n);
         m_max_generation = n->get_generation();
 
-        if (m_ast_manager.has_trace_stream()) {
+        if (track_used_enodes()) {
             m_used_enodes.reset();
             m_used_enodes.push_back(n);
         }
@@ -2655,7 +2661,7 @@ namespace smt {
         backtrack_point & bp = m_backtrack_stack[m_top - 1];
         m_max_generation     = bp.m_old_max_generation;
 
-        if (m_ast_manager.has_trace_stream())
+        if (track_used_enodes())
             m_used_enodes.shrink(bp.m_old_used_enodes_size);
 
         TRACE("mam_int", tout << "backtrack top: " << bp.m_instr << " " << *(bp.m_instr) << "\n";);
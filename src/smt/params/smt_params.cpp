@@ -37,7 +37,13 @@ void smt_params::updt_local_params(params_ref const & _p) {
     m_timeout = p.timeout();
     m_rlimit  = p.rlimit();
     m_max_conflicts = p.max_conflicts();
+    m_threads = p.threads();
+    m_threads_max_conflicts = p.threads_max_conflicts();
+    m_threads_share_size = p.threads_share_size();
     m_core_validate = p.core_validate();
+    m_lemma_gc_tiers = p.lemma_gc_tiers();
+    m_lemma_gc_core_glue = p.lemma_gc_core_glue();
+    m_lemma_gc_tier2_glue = p.lemma_gc_tier2_glue();
     m_logic = _p.get_sym("logic", m_logic);
     model_params mp(_p);
     m_model_compact = mp.compact();
@@ -95,6 +95,9 @@ struct smt_params : public preprocessor_params,
     unsigned         m_phase_caching_off;
     bool             m_minimize_lemmas;
     unsigned         m_max_conflicts;
+    unsigned         m_threads;
+    unsigned         m_threads_max_conflicts;
+    unsigned         m_threads_share_size;
     bool             m_simplify_clauses;
     unsigned         m_tick;
     bool             m_display_features;
@@ -153,6 +156,9 @@ struct smt_params : public preprocessor_params,
     unsigned          m_new_clause_relevancy; //!< Max. number of unassigned literals to be considered relevant.
     unsigned          m_old_clause_relevancy; //!< Max. number of unassigned literals to be considered relevant.
     double            m_inv_clause_decay;     //!< clause activity decay
+    bool              m_lemma_gc_tiers;       //!< delete lemmas based on their glue.
+    unsigned          m_lemma_gc_core_glue;   //!< lemmas with glue at most this value are never deleted.
+    unsigned          m_lemma_gc_tier2_glue;  //!< lemmas with glue at most this value are kept while they are used.
     
     // -----------------------------------
     //
@@ -231,6 +237,9 @@ struct smt_params : public preprocessor_params,
         m_phase_caching_off(100),
         m_minimize_lemmas(true),
         m_max_conflicts(UINT_MAX),
+        m_threads(1),
+        m_threads_max_conflicts(400),
+        m_threads_share_size(3),
         m_simplify_clauses(true),
         m_tick(1000),
         m_display_features(false),
@@ -259,6 +268,9 @@ struct smt_params : public preprocessor_params,
         m_new_clause_relevancy(45), 
         m_old_clause_relevancy(6),
         m_inv_clause_decay(1),
+        m_lemma_gc_tiers(false),
+        m_lemma_gc_core_glue(2),
+        m_lemma_gc_tier2_glue(6),
         m_smtlib_dump_lemmas(false),
         m_logic(symbol::null),
         m_profile_res_sub(false),
@@ -28,7 +28,8 @@ enum arith_solver_id {
     AS_ARITH,
     AS_DENSE_DIFF_LOGIC,
     AS_UTVPI,
-    AS_OPTINF
+    AS_OPTINF,
+    AS_FLOAT_ARITH
 };
 
 enum bound_prop_mode {
@@ -81,6 +82,10 @@ struct theory_arith_params {
 
     arith_pivot_strategy    m_arith_pivot_strategy;
 
+    // used by AS_FLOAT_ARITH: number of exact pivots in a call to make_feasible
+    // before the search for a feasible basis continues in double precision.
+    unsigned                m_arith_float_pivot_threshold;
+
     // used in diff-logic
     bool                    m_arith_add_binary_bounds;
     arith_prop_strategy     m_arith_propagation_strategy;
@@ -137,6 +142,7 @@ struct theory_arith_params {
         m_arith_adaptive_gcd(false),
         m_arith_propagation_threshold(UINT_MAX),
         m_arith_pivot_strategy(ARITH_PIVOT_SMALLEST),
+        m_arith_float_pivot_threshold(8),
         m_arith_add_binary_bounds(false),
         m_arith_propagation_strategy(ARITH_PROP_PROPORTIONAL),
         m_arith_eq_bounds(false),
@@ -0,0 +1,261 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    qi_profiler.cpp
+
+Abstract:
+
+    Profiler for quantifier instantiation (qi.profile).
+
+Revision History:
+
+--*/
+#include"qi_profiler.h"
+#include"smt_context.h"
+#include"ast_smt2_pp.h"
+
+namespace smt {
+
+    qi_profiler::qi_profiler(context & ctx):
+        m_context(ctx),
+        m_manager(ctx.get_manager()),
+        m_pinned(m_manager),
+        m_created(m_manager),
+        m_curr_match(UINT_MAX),
+        m_curr_generation(0),
+        m_curr_num_enodes(0),
+        m_curr_time(0) {
+    }
+
+    unsigned qi_profiler::get_quantifier(quantifier * q) {
+        unsigned idx;
+        if (m_quantifier2idx.find(q, idx))
+            return idx;
+        idx = m_quantifiers.size();
+        m_quantifier2idx.insert(q, idx);
+        m_quantifiers.push_back(quantifier_info(q));
+        m_pinned.push_back(q);
+        return idx;
+    }
+
+    unsigned qi_profiler::get_trigger(quantifier_info & info, app * pat) {
+        for (unsigned i = 0; i < info.m_triggers.size(); ++i) {
+            if (info.m_triggers[i].m_pattern == pat)
+                return i;
+        }
+        info.m_triggers.push_back(trigger_info(pat));
+        return info.m_triggers.size() - 1;
+    }
+
+    void qi_profiler::add_parent(unsigned begin, enode * n) {
+        unsigned id;
+        if (!m_creator.find(n->get_owner(), id))
+            return;
+        for (unsigned i = begin; i < m_parents.size(); ++i) {
+            if (m_parents[i] == id)
+                return;
+        }
+        m_parents.push_back(id);
+    }
+
+    unsigned qi_profiler::new_match(quantifier * q, app * pat, unsigned num_bindings, enode * const * bindings, ptr_vector<enode> const & used_enodes) {
+        unsigned qidx = get_quantifier(q);
+        quantifier_info & info = m_quantifiers[qidx];
+        match_info m;
+        m.m_quantifier    = qidx;
+        m.m_trigger       = get_trigger(info, pat);
+        m.m_parents_begin = m_parents.size();
+        info.m_num_matches++;
+        info.m_triggers[m.m_trigger].m_num_matches++;
+        for (unsigned i = 0; i < num_bindings; ++i)
+            add_parent(m.m_parents_begin, bindings[i]);
+        for (unsigned i = 0; i < used_enodes.size(); ++i)
+            add_parent(m.m_parents_begin, used_enodes[i]);
+        m.m_parents_end = m_parents.size();
+        m_matches.push_back(m);
+        return m_matches.size() - 1;
+    }
+
+    void qi_profiler::start_instance(unsigned match_id, unsigned generation) {
+        SASSERT(match_id < m_matches.size());
+        m_curr_match      = match_id;
+        m_curr_generation = generation;
+        m_curr_num_enodes = static_cast<unsigned>(m_context.end_enodes() - m_context.begin_enodes());
+        m_curr_time       = m_internalize_watch.get_seconds();
+        m_internalize_watch.start();
+    }
+
+    void qi_profiler::end_instance() {
+        m_internalize_watch.stop();
+        match_info const & m = m_matches[m_curr_match];
+        quantifier_info & info = m_quantifiers[m.m_quantifier];
+        info.m_internalize_time += m_internalize_watch.get_seconds() - m_curr_time;
+        info.m_num_instances++;
+        info.m_triggers[m.m_trigger].m_num_instances++;
+        info.m_generations.reserve(m_curr_generation + 1, 0);
+        info.m_generations[m_curr_generation]++;
+
+        unsigned depth = 0;
+        for (unsigned i = m.m_parents_begin; i < m.m_parents_end; ++i) {
+            instance_info const & p = m_instances[m_parents[i]];
+            depth = std::max(depth, p.m_depth);
+            m_quantifiers[p.m_quantifier].m_children.insert_if_not_there2(m.m_quantifier, 0)->get_data().m_value++;
+        }
+        instance_info inst;
+        inst.m_quantifier = m.m_quantifier;
+        inst.m_depth      = depth + 1;
+        info.m_max_depth  = std::max(info.m_max_depth, inst.m_depth);
+        unsigned id = m_instances.size();
+        m_instances.push_back(inst);
+
+        // the enodes created by the internalization of the instance
+        ptr_vector<enode>::const_iterator it  = m_context.begin_enodes() + m_curr_num_enodes;
+        ptr_vector<enode>::const_iterator end = m_context.end_enodes();
+        for (; it != end; ++it) {
+            expr * e = (*it)->get_owner();
+            if (!m_creator.contains(e))
+                m_created.push_back(e);
+            m_creator.insert(e, id);
+        }
+        m_curr_match = UINT_MAX;
+    }
+
+    /**
+       \brief Mark the quantifiers that are on a cycle of the causal graph.
+       The strongly connected components are computed using Tarjan's algorithm.
+    */
+    void qi_profiler::find_loops(svector<bool> & in_loop) const {
+        unsigned n = m_quantifiers.size();
+        vector<unsigned_vector> succ;
+        succ.resize(n);
+        in_loop.reset();
+        in_loop.resize(n, false);
+        for (unsigned i = 0; i < n; ++i) {
+            u_map<unsigned>::iterator it  = m_quantifiers[i].m_children.begin();
+            u_map<unsigned>::iterator end = m_quantifiers[i].m_children.end();
+            for (; it != end; ++it) {
+                succ[i].push_back(it->m_key);
+                if (it->m_key == i)
+                    in_loop[i] = true;
+            }
+        }
+        unsigned_vector index, low, stack;
+        svector<bool> on_stack;
+        svector<std::pair<unsigned, unsigned> > todo;
+        index.resize(n, UINT_MAX);
+        low.resize(n, 0);
+        on_stack.resize(n, false);
+        unsigned counter = 0;
+        for (unsigned r = 0; r < n; ++r) {
+            if (index[r] != UINT_MAX)
+                continue;
+            index[r] = low[r] = counter++;
+            stack.push_back(r);
+            on_stack[r] = true;
+            todo.push_back(std::make_pair(r, 0u));
+            while (!todo.empty()) {
+                unsigned v = todo.back().first;
+                if (todo.back().second < succ[v].size()) {
+                    unsigned w = succ[v][todo.back().second++];
+                    if (index[w] == UINT_MAX) {
+                        index[w] = low[w] = counter++;
+                        stack.push_back(w);
+                        on_stack[w] = true;
+                        todo.push_back(std::make_pair(w, 0u));
+                    }
+                    else if (on_stack[w]) {
+                        low[v] = std::min(low[v], index[w]);
+                    }
+                    continue;
+                }
+                todo.pop_back();
+                if (!todo.empty()) {
+                    unsigned u = todo.back().first;
+                    low[u] = std::min(low[u], low[v]);
+                }
+                if (low[v] == index[v]) {
+                    unsigned sz = stack.size();
+                    unsigned w;
+                    do {
+                        w = stack.back();
+                        stack.pop_back();
+                        on_stack[w] = false;
+                    }
+                    while (w != v);
+                    if (sz - stack.size() > 1) {
+                        for (unsigned i = stack.size(); i < sz; ++i)
+                            in_loop[stack.c_ptr()[i]] = true;
+                    }
+                }
+            }
+        }
+    }
+
+    void qi_profiler::display_string(std::ostream & out, char const * s) const {
+        out << "\"";
+        for (; *s; ++s) {
+            switch (*s) {
+            case '"':  out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(*s) < 0x20)
+                    out << " ";
+                else
+                    out << *s;
+            }
+        }
+        out << "\"";
+    }
+
+    void qi_profiler::display_json(std::ostream & out) const {
+        svector<bool> in_loop;
+        find_loops(in_loop);
+        params_ref p;
+        p.set_bool("single_line", true);
+        out << "{\"ematching_time\": " << m_ematching_watch.get_seconds()
+            << ", \"num_instances\": " << m_instances.size()
+            << ", \"quantifiers\": [";
+        for (unsigned i = 0; i < m_quantifiers.size(); ++i) {
+            quantifier_info const & info = m_quantifiers[i];
+            quantifier * q = info.m_quantifier;
+            out << (i == 0 ? "\n" : ",\n");
+            out << "  {\"index\": " << i << ", \"qid\": ";
+            display_string(out, q->get_qid().str().c_str());
+            out << ", \"matches\": " << info.m_num_matches
+                << ", \"instances\": " << info.m_num_instances
+                << ", \"internalize_time\": " << info.m_internalize_time
+                << ", \"max_depth\": " << info.m_max_depth
+                << ", \"matching_loop\": " << ((in_loop[i] && info.m_max_depth >= LOOP_DEPTH) ? "true" : "false");
+            out << ",\n   \"generations\": [";
+            for (unsigned j = 0; j < info.m_generations.size(); ++j)
+                out << (j == 0 ? "" : ", ") << info.m_generations[j];
+            out << "],\n   \"triggers\": [";
+            for (unsigned j = 0; j < info.m_triggers.size(); ++j) {
+                trigger_info const & t = info.m_triggers[j];
+                out << (j == 0 ? "" : ", ") << "{\"pattern\": ";
+                if (t.m_pattern) {
+                    std::ostringstream strm;
+                    for (unsigned k = 0; k < t.m_pattern->get_num_args(); ++k)
+                        strm << (k == 0 ? "" : " ") << mk_ismt2_pp(t.m_pattern->get_arg(k), m_manager, p, 0, q->get_num_decls(), "x");
+                    display_string(out, strm.str().c_str());
+                }
+                else {
+                    out << "null";
+                }
+                out << ", \"matches\": " << t.m_num_matches << ", \"instances\": " << t.m_num_instances << "}";
+            }
+            out << "],\n   \"children\": [";
+            u_map<unsigned>::iterator it  = info.m_children.begin();
+            u_map<unsigned>::iterator end = info.m_children.end();
+            for (bool first = true; it != end; ++it, first = false)
+                out << (first ? "" : ", ") << "{\"index\": " << it->m_key << ", \"instances\": " << it->m_value << "}";
+            out << "]}";
+        }
+        out << "]}\n";
+    }
+
+};
@@ -0,0 +1,126 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    qi_profiler.h
+
+Abstract:
+
+    Profiler for quantifier instantiation (qi.profile).
+
+    It records, for each quantifier and each of its triggers, the
+    number of matches and instances, the time spent internalizing
+    instances, and a histogram of the generation of the instances.
+
+    It also builds the causal graph of the instances: an instance
+    depends on the instances that created the terms used to match
+    it. The graph is aggregated per quantifier, and the length of the
+    longest chain of instances is tracked. A quantifier that lies on
+    a cycle of this graph and produced long chains is reported as a
+    likely matching loop.
+
+Revision History:
+
+--*/
+#ifndef QI_PROFILER_H_
+#define QI_PROFILER_H_
+
+#include"ast.h"
+#include"obj_hashtable.h"
+#include"map.h"
+#include"stopwatch.h"
+#include"smt_types.h"
+
+namespace smt {
+    class context;
+
+    class qi_profiler {
+        struct trigger_info {
+            app *    m_pattern; // 0 for instances that were not produced by E-matching.
+            unsigned m_num_matches;
+            unsigned m_num_instances;
+            trigger_info(app * p):m_pattern(p), m_num_matches(0), m_num_instances(0) {}
+        };
+
+        struct quantifier_info {
+            quantifier *          m_quantifier;
+            svector<trigger_info> m_triggers;
+            unsigned              m_num_matches;
+            unsigned              m_num_instances;
+            unsigned              m_max_depth;
+            double                m_internalize_time;
+            unsigned_vector       m_generations; //!< number of instances for each generation.
+            u_map<unsigned>       m_children;    //!< quantifier index -> number of instances that depend on an instance of this quantifier.
+            quantifier_info(quantifier * q = 0):
+                m_quantifier(q), m_num_matches(0), m_num_instances(0), m_max_depth(0), m_internalize_time(0) {}
+        };
+
+        struct match_info {
+            unsigned m_quantifier;
+            unsigned m_trigger;
+            unsigned m_parents_begin; //!< range of m_parents containing the instances this match depends on.
+            unsigned m_parents_end;
+        };
+
+        struct instance_info {
+            unsigned m_quantifier;
+            unsigned m_depth;         //!< length of the longest chain of instances ending in this instance.
+        };
+
+        /**
+           \brief A quantifier whose instances form chains of at least this length
+           through a cycle of the causal graph is reported as a matching loop.
+        */
+        static const unsigned LOOP_DEPTH = 10;
+
+        context &                     m_context;
+        ast_manager &                 m_manager;
+        quantifier_ref_vector         m_pinned;
+        obj_map<quantifier, unsigned> m_quantifier2idx;
+        vector<quantifier_info>       m_quantifiers;
+        svector<match_info>           m_matches;
+        unsigned_vector               m_parents;
+        svector<instance_info>        m_instances;
+        expr_ref_vector               m_created;
+        obj_map<expr, unsigned>       m_creator;       //!< term -> instance that created its enode.
+        stopwatch                     m_ematching_watch;
+        stopwatch                     m_internalize_watch;
+        unsigned                      m_curr_match;
+        unsigned                      m_curr_generation;
+        unsigned                      m_curr_num_enodes;
+        double                        m_curr_time;
+
+        unsigned get_quantifier(quantifier * q);
+        unsigned get_trigger(quantifier_info & info, app * pat);
+        void add_parent(unsigned begin, enode * n);
+        void find_loops(svector<bool> & in_loop) const;
+        void display_string(std::ostream & out, char const * s) const;
+
+    public:
+        qi_profiler(context & ctx);
+
+        /**
+           \brief Record a match of quantifier q using the trigger pat. The bindings and the
+           enodes used by the match determine the instances it depends on.
+           Return an identifier for the match.
+        */
+        unsigned new_match(quantifier * q, app * pat, unsigned num_bindings, enode * const * bindings, ptr_vector<enode> const & used_enodes);
+
+        /**
+           \brief Bracket the internalization of the instance for the given match.
+        */
+        void start_instance(unsigned match_id, unsigned generation);
+        void end_instance();
+
+        void start_ematching() { m_ematching_watch.start(); }
+        void stop_ematching() { m_ematching_watch.stop(); }
+
+        /**
+           \brief Display the profile as a JSON object.
+        */
+        void display_json(std::ostream & out) const;
+    };
+};
+
+#endif /* QI_PROFILER_H_ */
@@ -37,6 +37,7 @@ namespace smt {
         m_parser(m_manager),
         m_evaluator(m_manager),
         m_subst(m_manager),
+        m_profiler(ctx),
         m_instances(m_manager) {
         init_parser_vars();
         m_vals.resize(15, 0.0f);
@@ -133,7 +134,7 @@ namespace smt {
         return static_cast<unsigned>(r);
     }
     
-    void qi_queue::insert(fingerprint * f, app * pat, unsigned generation, unsigned min_top_generation, unsigned max_top_generation) {
+    void qi_queue::insert(fingerprint * f, app * pat, unsigned generation, unsigned min_top_generation, unsigned max_top_generation, ptr_vector<enode> const & used_enodes) {
         quantifier * q         = static_cast<quantifier*>(f->get_data());
         float cost             = get_cost(q, pat, generation, min_top_generation, max_top_generation);
         TRACE("qi_queue_detail", 
@@ -144,7 +145,10 @@ namespace smt {
               }
               tout << "\n";);
         TRACE("new_entries_bug", tout << "[qi:insert]\n";);
-        m_new_entries.push_back(entry(f, cost, generation));
+        unsigned match_id = UINT_MAX;
+        if (m_params.m_qi_profile)
+            match_id = m_profiler.new_match(q, pat, f->get_num_args(), f->get_args(), used_enodes);
+        m_new_entries.push_back(entry(f, cost, generation, match_id));
     }
 
     void qi_queue::instantiate() {
@@ -291,7 +295,11 @@ namespace smt {
         m_stats.m_num_instances++;
         unsigned gen = get_new_gen(q, generation, ent.m_cost);
         display_instance_profile(f, q, num_bindings, bindings, proof_id, gen);
+        if (m_params.m_qi_profile)
+            m_profiler.start_instance(ent.m_match, gen);
         m_context.internalize_instance(lemma, pr1, gen);
+        if (m_params.m_qi_profile)
+            m_profiler.end_instance();
         TRACE_CODE({
             static unsigned num_useless = 0;
             if (m_manager.is_or(lemma)) {
@@ -29,6 +29,7 @@ Revision History:
 #include"cost_evaluator.h"
 #include"cached_var_subst.h"
 #include"statistics.h"
+#include"qi_profiler.h"
 
 namespace smt {
     class context;
@@ -53,12 +54,14 @@ namespace smt {
         cached_var_subst              m_subst;
         svector<float>                m_vals;
         double                        m_eager_cost_threshold;
+        qi_profiler                   m_profiler;
         struct entry {
             fingerprint * m_qb;
             float         m_cost;
             unsigned      m_generation:31;
             unsigned      m_instantiated:1;
-            entry(fingerprint * f, float c, unsigned g):m_qb(f), m_cost(c), m_generation(g), m_instantiated(false) {}
+            unsigned      m_match; //!< match identifier in m_profiler, only used if qi.profile is set.
+            entry(fingerprint * f, float c, unsigned g, unsigned m):m_qb(f), m_cost(c), m_generation(g), m_instantiated(false), m_match(m) {}
         };
         svector<entry>                m_new_entries;
         svector<entry>                m_delayed_entries;
@@ -85,9 +88,10 @@ namespace smt {
         void setup();
         /**
            \brief Insert a new quantifier in the queue, f contains the quantifier and bindings.
-           f->get_data() is the quantifier.
+           f->get_data() is the quantifier. used_enodes are the enodes used to match pat, they
+           are only tracked if qi.profile is set or the trace stream is enabled.
         */
-        void insert(fingerprint * f, app * pat, unsigned generation, unsigned min_top_generation, unsigned max_top_generation);
+        void insert(fingerprint * f, app * pat, unsigned generation, unsigned min_top_generation, unsigned max_top_generation, ptr_vector<enode> const & used_enodes);
         void instantiate();
         bool has_work() const { return !m_new_entries.empty(); }
         void init_search_eh();
@@ -97,6 +101,8 @@ namespace smt {
         void reset();
         void display_delayed_instances_stats(std::ostream & out) const;
         void collect_statistics(::statistics & st) const;
+        qi_profiler & get_profiler() { return m_profiler; }
+        qi_profiler const & get_profiler() const { return m_profiler; }
     };
 };
 
@@ -0,0 +1,121 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    smt_consequences.cpp
+
+Abstract:
+
+    Consequence finding for the logical context.
+
+    Given a set of assumptions and a set of variables, find the
+    values of the variables that are implied by the assertions and
+    the assumptions. The models produced by the search filter the
+    candidate values, and each remaining candidate is confirmed by a
+    check with its negation as an extra assumption. All checks share
+    the same context, so the lemmas learned in a check are available
+    to the next ones.
+
+Revision History:
+
+--*/
+#include"smt_context.h"
+#include"ast_util.h"
+
+namespace smt {
+
+    /**
+       \brief Return the literal (as an expression) stating that v has value val.
+       Return 0 if the value cannot be used in an assumption.
+    */
+    static expr * mk_value_literal(ast_manager & m, expr * v, expr * val) {
+        if (m.is_bool(v)) {
+            if (m.is_true(val))
+                return v;
+            if (m.is_false(val))
+                return m.mk_not(v);
+            return 0;
+        }
+        // values of uninterpreted sorts are not terms of the context.
+        if (m.is_uninterp(m.get_sort(v)) || !m.is_value(val))
+            return 0;
+        return m.mk_eq(v, val);
+    }
+
+    /**
+       \brief Store in conseq an implication (=> (and a_1 ... a_k) lit) for every variable v in vars
+       whose value is fixed by the assertions and the assumptions, where lit states the value of v
+       and a_1 ... a_k are assumptions that imply it.
+       The result is l_false if the assertions and the assumptions are unsatisfiable, and l_undef
+       if one of the checks failed.
+    */
+    lbool context::get_consequences(expr_ref_vector const & assumptions, expr_ref_vector const & vars, expr_ref_vector & conseq) {
+        lbool is_sat = check(assumptions.size(), assumptions.c_ptr());
+        if (is_sat != l_true)
+            return is_sat;
+        model_ref mdl;
+        get_model(mdl);
+        expr_ref_vector lits(m_manager);
+        for (unsigned i = 0; i < vars.size(); ++i) {
+            expr_ref val(m_manager);
+            if (!mdl->eval(vars[i], val, true))
+                continue;
+            expr * lit = mk_value_literal(m_manager, vars[i], val);
+            if (lit)
+                lits.push_back(lit);
+        }
+
+        // candidates assigned by propagation of the assumptions are fixed.
+        unsigned j = 0;
+        for (unsigned i = 0; i < lits.size(); ++i) {
+            expr * lit = lits.get(i);
+            if (b_internalized(lit) && get_assignment(get_literal(lit)) == l_true && get_assign_level(get_literal(lit)) <= m_search_lvl) {
+                expr_ref ante(m_manager.mk_true(), m_manager);
+                if (get_assign_level(get_literal(lit)) > m_base_lvl)
+                    ante = mk_and(assumptions);
+                conseq.push_back(m_manager.mk_implies(ante, lit));
+                continue;
+            }
+            lits.set(j++, lit);
+        }
+        lits.shrink(j);
+
+        expr_ref_vector asms(assumptions);
+        while (!lits.empty()) {
+            expr_ref lit(lits.back(), m_manager);
+            lits.pop_back();
+            asms.push_back(mk_not(m_manager, lit));
+            is_sat = check_core(asms.size(), asms.c_ptr(), true);
+            asms.pop_back();
+            switch (is_sat) {
+            case l_undef:
+                return l_undef;
+            case l_false: {
+                expr_ref_vector ante(m_manager);
+                for (unsigned i = 0; i < get_unsat_core_size(); ++i) {
+                    if (assumptions.contains(get_unsat_core_expr(i)))
+                        ante.push_back(get_unsat_core_expr(i));
+                }
+                conseq.push_back(m_manager.mk_implies(mk_and(ante), lit));
+                break;
+            }
+            case l_true: {
+                // the candidates that are false in the new model are not fixed.
+                get_model(mdl);
+                j = 0;
+                for (unsigned i = 0; i < lits.size(); ++i) {
+                    expr_ref val(m_manager);
+                    if (mdl->eval(lits.get(i), val, true) && m_manager.is_true(val))
+                        lits.set(j++, lits.get(i));
+                }
+                lits.shrink(j);
+                break;
+            }
+            }
+        }
+        IF_VERBOSE(2, verbose_stream() << "(smt.consequences :vars " << vars.size() << " :fixed " << conseq.size() << ")\n";);
+        return l_true;
+    }
+
+};
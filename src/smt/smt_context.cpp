@@ -2658,11 +2658,20 @@ namespace smt {
         bool operator()(clause * cls1, clause * cls2) const { return cls1->get_activity() > cls2->get_activity(); }
     };
 
+    struct clause_glue_lt {
+        bool operator()(clause * cls1, clause * cls2) const { 
+            return cls1->get_glue() < cls2->get_glue() || 
+                (cls1->get_glue() == cls2->get_glue() && cls1->get_activity() > cls2->get_activity()); 
+        }
+    };
+
     /**
        \brief Delete low activity lemmas
     */
     inline void context::del_inactive_lemmas() {
-        if (m_fparams.m_lemma_gc_half)
+        if (m_fparams.m_lemma_gc_tiers)
+            del_inactive_lemmas3();
+        else if (m_fparams.m_lemma_gc_half)
             del_inactive_lemmas1();
         else
             del_inactive_lemmas2();
@@ -2778,6 +2787,79 @@ namespace smt {
         IF_VERBOSE(2, verbose_stream() << " :num-deleted-clauses " << num_del_cls << ")" << std::endl;);
     }
 
+    /**
+       \brief Tiered version of del_inactive_lemmas based on the glue of the lemmas.
+       Lemmas with glue at most m_lemma_gc_core_glue are kept. Lemmas with glue at most 
+       m_lemma_gc_tier2_glue are kept if they were used in conflict resolution since the 
+       last garbage collection. Half of the other lemmas are deleted: the ones with higher glue,
+       and among them the ones with lower activity.
+       The activity of a lemma counts the conflicts it was used in since the last garbage collection.
+    */
+    void context::del_inactive_lemmas3() {
+        unsigned sz            = m_lemmas.size();
+        unsigned start_at      = m_base_lvl == 0 ? 0 : m_base_scopes[m_base_lvl - 1].m_lemmas_lim;
+        SASSERT(start_at <= sz);
+        if (start_at + m_fparams.m_recent_lemmas_size >= sz)
+            return;
+        IF_VERBOSE(2, verbose_stream() << "(smt.delete-inactive-lemmas"; verbose_stream().flush(););
+        unsigned end_at        = sz - m_fparams.m_recent_lemmas_size;
+        unsigned core_glue     = m_fparams.m_lemma_gc_core_glue;
+        unsigned tier2_glue    = m_fparams.m_lemma_gc_tier2_glue;
+        unsigned i             = start_at;
+        unsigned j             = i;
+        unsigned num_del_cls   = 0;
+        clause_vector candidates;
+        for (; i < end_at; i++) {
+            clause * cls = m_lemmas[i];
+            if (!can_delete(cls)) {
+                m_lemmas[j] = cls;
+                j++;
+            }
+            else if (cls->deleted()) {
+                del_clause(cls);
+                num_del_cls++;
+            }
+            else if (cls->get_glue() <= core_glue || (cls->get_glue() <= tier2_glue && cls->get_activity() > 1)) {
+                m_lemmas[j] = cls;
+                j++;
+            }
+            else {
+                candidates.push_back(cls);
+            }
+        }
+        std::stable_sort(candidates.begin(), candidates.end(), clause_glue_lt());
+        unsigned num_kept = candidates.size() / 2;
+        for (unsigned k = 0; k < candidates.size(); k++) {
+            clause * cls = candidates[k];
+            if (k < num_kept) {
+                m_lemmas[j] = cls;
+                j++;
+            }
+            else {
+                TRACE("del_inactive_lemmas", tout << "deleting: "; display_clause(tout, cls); tout << ", glue: " << 
+                      cls->get_glue() << ", activity: " << cls->get_activity() << "\n";);
+                del_clause(cls);
+                num_del_cls++;
+            }
+        }
+        // keep recent clauses
+        for (; i < sz; i++) {
+            clause * cls = m_lemmas[i];
+            if (cls->deleted() && can_delete(cls)) {
+                del_clause(cls);
+                num_del_cls++;
+            }
+            else {
+                m_lemmas[j] = cls;
+                j++;
+            }
+        }
+        m_lemmas.shrink(j);
+        for (i = start_at; i < j; i++) 
+            m_lemmas[i]->set_activity(1);
+        IF_VERBOSE(2, verbose_stream() << " :num-deleted-clauses " << num_del_cls << " :num-lemmas " << j - start_at << ")" << std::endl;);
+    }
+
     /**
        \brief Return true if "cls" has more than (or equal to) k unassigned literals.
     */
@@ -3101,6 +3183,8 @@ namespace smt {
             return l_undef;
         SASSERT(m_scope_lvl == 0);
         SASSERT(!m_setup.already_configured());
+        if (use_parallel())
+            return check_parallel(0, 0);
         setup_context(m_fparams.m_auto_config);
         internalize_assertions();
         lbool r = l_undef;
@@ -3165,6 +3249,16 @@ namespace smt {
     }
 
     lbool context::check(unsigned num_assumptions, expr * const * assumptions, bool reset_cancel) {
+        if (!validate_assumptions(num_assumptions, assumptions))
+            return l_undef;
+        return check_core(num_assumptions, assumptions, reset_cancel);
+    }
+
+    /**
+       \brief Check with arbitrary formulas as assumptions. The unsat core is only
+       meaningful if the assumptions are literals.
+    */
+    lbool context::check_core(unsigned num_assumptions, expr * const * assumptions, bool reset_cancel) {
         m_stats.m_num_checks++;
         TRACE("check_bug", tout << "STARTING check(num_assumptions, assumptions)\n";
               tout << "inconsistent: " << inconsistent() << ", m_unsat_core.empty(): " << m_unsat_core.empty() << "\n";
@@ -3175,8 +3269,8 @@ namespace smt {
             m_unsat_core.reset();
         if (!check_preamble(reset_cancel))
             return l_undef;
-        if (!validate_assumptions(num_assumptions, assumptions))
-            return l_undef;
+        if (use_parallel())
+            return check_parallel(num_assumptions, assumptions);
         TRACE("check_bug", tout << "inconsistent: " << inconsistent() << ", m_unsat_core.empty(): " << m_unsat_core.empty() << "\n";);
         TRACE("unsat_core_bug", for (unsigned i = 0; i < num_assumptions; i++) { tout << mk_pp(assumptions[i], m_manager) << "\n";});
         pop_to_base_lvl();
@@ -3937,6 +4031,37 @@ namespace smt {
         }
     }
 
+    void context::get_units(expr_ref_vector & result) {
+        unsigned lim = m_scope_lvl == 0 ? m_assigned_literals.size() : m_scopes[0].m_assigned_literals_lim;
+        expr_ref lit(m_manager);
+        for (unsigned i = 0; i < lim; i++) {
+            literal l = m_assigned_literals[i];
+            if (l == true_literal)
+                continue;
+            literal2expr(l, lit);
+            result.push_back(lit);
+        }
+    }
+
+    void context::get_lemmas(unsigned max_size, expr_ref_vector & result) {
+        expr_ref_vector lits(m_manager);
+        expr_ref lit(m_manager);
+        clause_vector::const_iterator it  = m_lemmas.begin();
+        clause_vector::const_iterator end = m_lemmas.end();
+        for (; it != end; ++it) {
+            clause const & cls = *(*it);
+            unsigned num_lits  = cls.get_num_literals();
+            if (num_lits > max_size)
+                continue;
+            lits.reset();
+            for (unsigned i = 0; i < num_lits; i++) {
+                literal2expr(cls.get_literal(i), lit);
+                lits.push_back(lit);
+            }
+            result.push_back(mk_or(lits));
+        }
+    }
+
     /**
        \brief Undo object for bool var m_true_first field update.
     */
@@ -68,6 +68,7 @@ namespace smt {
         friend class model_generator;
     public:
         statistics                  m_stats;
+        ::statistics                m_aux_stats; // statistics of the threads created by check_parallel
 
         std::ostream& display_last_failure(std::ostream& out) const;
         std::string last_failure_as_string() const;
@@ -164,6 +165,7 @@ namespace smt {
         svector<double>             m_activity;    
         clause_vector               m_aux_clauses; 
         clause_vector               m_lemmas;
+        svector<bool>               m_diff_levels; //!< auxiliary vector for computing the glue of lemmas
         vector<clause_vector>       m_clauses_to_reinit;
         expr_ref_vector             m_units_to_reassert;
         svector<char>               m_units_to_reassert_sign;
@@ -743,6 +745,8 @@ namespace smt {
         
         unsigned get_max_iscope_lvl(unsigned num_lits, literal const * lits) const;
 
+        unsigned get_glue(unsigned num_lits, literal const * lits);
+
         bool use_binary_clause_opt(literal l1, literal l2, bool lemma) const;
 
         int select_learned_watch_lit(clause const * cls) const;
@@ -754,6 +758,8 @@ namespace smt {
         proof * mk_clause_def_axiom(unsigned num_lits, literal * lits, expr * root_gate);
 
     public:
+        void update_glue(clause * cls);
+
         void mk_gate_clause(unsigned num_lits, literal * lits);
 
         void mk_gate_clause(literal l1, literal l2);
@@ -1032,6 +1038,8 @@ namespace smt {
 
         void del_inactive_lemmas2();
 
+        void del_inactive_lemmas3();
+
         bool more_than_k_unassigned_literals(clause * cls, unsigned k);
 
         void internalize_assertions();
@@ -1328,6 +1336,9 @@ namespace smt {
 #endif
         bool check_preamble(bool reset_cancel);
         lbool check_finalize(lbool r);
+        bool use_parallel() const;
+        lbool check_parallel(unsigned num_assumptions, expr * const * assumptions);
+        lbool check_core(unsigned num_assumptions, expr * const * assumptions, bool reset_cancel);
 
         // -----------------------------------
         //
@@ -1384,6 +1395,10 @@ namespace smt {
         lbool check(unsigned num_assumptions = 0, expr * const * assumptions = 0, bool reset_cancel = true);        
         
         lbool setup_and_check(bool reset_cancel = true);
+
+        lbool get_consequences(expr_ref_vector const & assumptions, expr_ref_vector const & vars, expr_ref_vector & conseq);
+
+        lbool cube(unsigned depth, expr_ref_vector & lits);
         
         // return 'true' if assertions are inconsistent.
         bool reduce_assertions(); 
@@ -1402,6 +1417,16 @@ namespace smt {
 
         void get_guessed_literals(expr_ref_vector & result);
 
+        /**
+           \brief Store in result the literals assigned at level 0.
+        */
+        void get_units(expr_ref_vector & result);
+
+        /**
+           \brief Store in result the learned clauses containing at most max_size literals.
+        */
+        void get_lemmas(unsigned max_size, expr_ref_vector & result);
+
         void internalize_assertion(expr * n, proof * pr, unsigned generation);
 
         void internalize_instance(expr * body, proof * pr, unsigned generation) {
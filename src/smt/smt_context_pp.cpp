@@ -400,6 +400,7 @@ namespace smt {
         st.update("backwd subs res", m_stats.m_num_bsr);
         st.update("frwrd subs res", m_stats.m_num_fsr);
 #endif
+        st.copy(m_aux_stats);
         m_qmanager->collect_statistics(st);
         m_asserted_formulas.collect_statistics(st);
         ptr_vector<theory>::const_iterator it  = m_theory_set.begin();
@@ -18,6 +18,7 @@ Revision History:
 --*/
 #include"smt_context.h"
 #include"ast_pp.h"
+#include<fstream>
 
 namespace smt {
 
@@ -155,5 +156,17 @@ namespace smt {
     void context::display_profile(std::ostream & out) const {
         if (m_fparams.m_profile_res_sub)
             display_profile_res_sub(out);
+        if (m_fparams.m_qi_profile) {
+            if (m_fparams.m_qi_profile_file.empty()) {
+                m_qmanager->display_profile(out);
+            }
+            else {
+                std::ofstream strm(m_fparams.m_qi_profile_file.c_str());
+                if (strm.fail())
+                    warning_msg("could not open file '%s' for the quantifier instantiation profile", m_fparams.m_qi_profile_file.c_str());
+                else
+                    m_qmanager->display_profile(strm);
+            }
+        }
     }
 };
@@ -0,0 +1,92 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    smt_cube.cpp
+
+Abstract:
+
+    Cube selection for the logical context.
+
+    A cube is built from the unassigned atoms with the highest
+    activity, using the cached phase of each atom. The activities
+    are accumulated by the previous checks, so the cubes split the
+    problem on the atoms that were involved in the most conflicts.
+    The literals of a cube are not propagated, so a cube may be
+    refuted as soon as it is checked.
+
+Revision History:
+
+--*/
+#include<algorithm>
+#include"smt_context.h"
+#include"for_each_expr.h"
+
+namespace smt {
+
+    namespace {
+        struct has_fresh_proc {
+            struct found {};
+            void operator()(var * n) {}
+            void operator()(app * n) { if (n->get_decl()->is_skolem()) throw found(); }
+            void operator()(quantifier * n) { throw found(); }
+        };
+
+        struct bool_var_act_gt {
+            svector<double> const & m_activity;
+            bool_var_act_gt(svector<double> const & a):m_activity(a) {}
+            bool operator()(bool_var v1, bool_var v2) const { return m_activity[v1] > m_activity[v2]; }
+        };
+    };
+
+    /**
+       \brief Return true if the atom can occur in a cube. Connectives and the
+       terms containing symbols that were not declared in the input are excluded.
+    */
+    static bool is_cube_atom(ast_manager & m, expr * e) {
+        if (!is_app(e))
+            return false;
+        app * a = to_app(e);
+        if (a->get_family_id() == m.get_basic_family_id() && !(m.is_eq(a) && !m.is_bool(a->get_arg(0))))
+            return false;
+        has_fresh_proc proc;
+        try {
+            for_each_expr(proc, e);
+        }
+        catch (has_fresh_proc::found) {
+            return false;
+        }
+        return true;
+    }
+
+    lbool context::cube(unsigned depth, expr_ref_vector & lits) {
+        lits.reset();
+        pop_to_base_lvl();
+        if (inconsistent())
+            return l_false;
+        setup_context(false);
+        internalize_assertions();
+        if (m_asserted_formulas.inconsistent())
+            return l_false;
+        if (inconsistent()) {
+            VERIFY(!resolve_conflict());
+            return l_false;
+        }
+        bool_var_vector vars;
+        for (bool_var v = 0; v < static_cast<bool_var>(get_num_bool_vars()); ++v) {
+            if (get_assignment(v) == l_undef && is_cube_atom(m_manager, bool_var2expr(v)))
+                vars.push_back(v);
+        }
+        std::stable_sort(vars.begin(), vars.end(), bool_var_act_gt(m_activity));
+        for (unsigned i = 0; i < vars.size() && i < depth; ++i) {
+            bool_var_data const & d = get_bdata(vars[i]);
+            bool phase = d.m_phase_available ? d.m_phase : m_phase_default;
+            expr * atom = bool_var2expr(vars[i]);
+            lits.push_back(phase ? atom : m_manager.mk_not(atom));
+        }
+        IF_VERBOSE(2, verbose_stream() << "(smt.cube :candidates " << vars.size() << " :size " << lits.size() << ")\n";);
+        return l_true;
+    }
+
+};
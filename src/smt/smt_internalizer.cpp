@@ -1157,6 +1157,45 @@ namespace smt {
         return r;
     }
 
+    /**
+       \brief Return the number of distinct decision levels of the assigned literals in lits.
+       The unassigned literals count as one extra level.
+    */
+    unsigned context::get_glue(unsigned num_lits, literal const * lits) {
+        m_diff_levels.reserve(m_scope_lvl + 1, false);
+        unsigned glue  = 0;
+        bool has_undef = false;
+        for (unsigned i = 0; i < num_lits; i++) {
+            if (get_assignment(lits[i]) == l_undef) {
+                has_undef = true;
+                continue;
+            }
+            unsigned lvl = get_assign_level(lits[i]);
+            if (!m_diff_levels[lvl]) {
+                m_diff_levels[lvl] = true;
+                glue++;
+            }
+        }
+        for (unsigned i = 0; i < num_lits; i++) {
+            if (get_assignment(lits[i]) != l_undef)
+                m_diff_levels[get_assign_level(lits[i])] = false;
+        }
+        return has_undef ? glue + 1 : glue;
+    }
+
+    /**
+       \brief Update the glue of a lemma that was used in conflict resolution.
+       The glue of a lemma only decreases.
+    */
+    void context::update_glue(clause * cls) {
+        SASSERT(cls->is_lemma());
+        if (!m_fparams.m_lemma_gc_tiers || cls->get_glue() <= m_fparams.m_lemma_gc_core_glue)
+            return;
+        unsigned glue = get_glue(cls->get_num_literals(), cls->begin_literals());
+        if (glue < cls->get_glue())
+            cls->set_glue(glue);
+    }
+
     /**
        \brief Return true if it safe to use the binary clause optimization at this point in time.
     */
@@ -1350,6 +1389,7 @@ namespace smt {
             clause * cls = clause::mk(m_manager, num_lits, lits, k, j, del_eh, save_atoms, m_bool_var2expr.c_ptr());
             if (lemma) {
                 cls->set_activity(activity);
+                cls->set_glue(get_glue(num_lits, lits));
                 if (k == CLS_LEARNED) {
                     int w2_idx  = select_learned_watch_lit(cls);
                     cls->swap_lits(1, w2_idx);
@@ -98,6 +98,14 @@ namespace smt {
         lbool check(unsigned num_assumptions, expr * const * assumptions) {
             return m_kernel.check(num_assumptions, assumptions);
         }
+
+        lbool get_consequences(expr_ref_vector const & assumptions, expr_ref_vector const & vars, expr_ref_vector & conseq) {
+            return m_kernel.get_consequences(assumptions, vars, conseq);
+        }
+
+        lbool cube(unsigned depth, expr_ref_vector & lits) {
+            return m_kernel.cube(depth, lits);
+        }
         
         void get_model(model_ref & m) const {
             m_kernel.get_model(m);
@@ -264,6 +272,14 @@ namespace smt {
         return r;
     }
 
+    lbool kernel::get_consequences(expr_ref_vector const & assumptions, expr_ref_vector const & vars, expr_ref_vector & conseq) {
+        return m_imp->get_consequences(assumptions, vars, conseq);
+    }
+
+    lbool kernel::cube(unsigned depth, expr_ref_vector & lits) {
+        return m_imp->cube(depth, lits);
+    }
+
     void kernel::get_model(model_ref & m) const {
         m_imp->get_model(m);
     }
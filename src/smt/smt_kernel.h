@@ -126,6 +126,20 @@ namespace smt {
 
         lbool check(app_ref_vector const& asms) { return check(asms.size(), (expr* const*)asms.c_ptr()); }
 
+        /**
+           \brief Find the values of vars that are implied by the asserted formulas and the assumptions.
+           For each such value, an implication (=> (and a_1 ... a_k) (= v val)) is added to conseq,
+           where a_1 ... a_k are assumptions. Boolean variables produce (=> (and a_1 ... a_k) v) or 
+           (=> (and a_1 ... a_k) (not v)).
+        */
+        lbool get_consequences(expr_ref_vector const & assumptions, expr_ref_vector const & vars, expr_ref_vector & conseq);
+
+        /**
+           \brief Store in lits a cube of at most depth literals over the atoms with the highest activity.
+           Return l_false if the asserted formulas are unsatisfiable.
+        */
+        lbool cube(unsigned depth, expr_ref_vector & lits);
+
         /**
            \brief Return the model associated with the last check command.
         */
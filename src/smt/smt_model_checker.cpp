@@ -350,6 +350,7 @@ namespace smt {
             m_fparams = alloc(smt_params, m_context->get_fparams());
             m_fparams->m_relevancy_lvl = 0; // no relevancy since the model checking problems are quantifier free
             m_fparams->m_case_split_strategy = CS_ACTIVITY; // avoid warning messages about smt.case_split >= 3.
+            m_fparams->m_qi_profile = false; // do not report the profile of the model checking problems.
         }
         if (!m_aux_context) {
             symbol logic;
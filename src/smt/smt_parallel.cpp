@@ -0,0 +1,246 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    smt_parallel.cpp
+
+Abstract:
+
+    Parallel portfolio for the logical context.
+
+    Each thread runs a copy of the context in its own ast_manager.
+    The copies use different random seeds. Every thread searches in
+    rounds with a bound on the number of conflicts. After a round, the
+    thread publishes the units and short lemmas it learned over atoms
+    that only contain symbols of the input, imports the ones published
+    by the other threads, and doubles the bound. The first thread that
+    finds an answer wins, and the other threads are canceled.
+
+Revision History:
+
+--*/
+#include"smt_context.h"
+#include"ast_translation.h"
+#include"decl_collector.h"
+#include"for_each_expr.h"
+#include"scoped_ptr_vector.h"
+#include"z3_omp.h"
+
+namespace smt {
+
+    struct scoped_limits {
+        reslimit&  m_limit;
+        unsigned   m_sz;
+        scoped_limits(reslimit& lim): m_limit(lim), m_sz(0) {}
+        ~scoped_limits() { for (unsigned i = 0; i < m_sz; ++i) m_limit.pop_child(); }
+        void push_child(reslimit* lim) { m_limit.push_child(lim); ++m_sz; }
+    };
+
+    /**
+       \brief Functor for checking whether an expression only contains
+       uninterpreted symbols from a given set.
+    */
+    struct shared_symbols_proc {
+        struct found {};
+        obj_hashtable<func_decl> const & m_decls;
+        shared_symbols_proc(obj_hashtable<func_decl> const & decls): m_decls(decls) {}
+        void operator()(var * n) {}
+        void operator()(quantifier * n) {}
+        void operator()(app * n) {
+            if (n->get_family_id() == null_family_id && !m_decls.contains(n->get_decl()))
+                throw found();
+        }
+    };
+
+    static bool only_shared_symbols(obj_hashtable<func_decl> const & decls, expr * e) {
+        shared_symbols_proc proc(decls);
+        try {
+            quick_for_each_expr(proc, e);
+        }
+        catch (shared_symbols_proc::found) {
+            return false;
+        }
+        return true;
+    }
+
+    /**
+       \brief Return true if the literal e is already assigned to true at level 0 in ctx.
+    */
+    static bool is_fixed(context & ctx, expr * e) {
+        bool sign = ctx.get_manager().is_not(e, e);
+        if (!ctx.b_internalized(e))
+            return false;
+        bool_var v = ctx.get_bool_var(e);
+        return ctx.get_assignment(v) == (sign ? l_false : l_true) && ctx.get_assign_level(v) == 0;
+    }
+
+    bool context::use_parallel() const {
+        if (m_fparams.m_threads <= 1 || m_base_lvl > 0 || m_manager.proofs_enabled())
+            return false;
+#ifdef _NO_OMP_
+        return false;
+#else
+        return 0 == omp_in_parallel();
+#endif
+    }
+
+    lbool context::check_parallel(unsigned num_assumptions, expr * const * assumptions) {
+        unsigned num_threads = m_fparams.m_threads;
+        scoped_ptr_vector<ast_manager>     managers;
+        scoped_ptr_vector<smt_params>      params;
+        scoped_ptr_vector<context>         contexts;
+        scoped_ptr_vector<expr_ref_vector> asms;
+        scoped_limits sl(m_manager.limit());
+
+        // units and lemmas are only exchanged if they use the symbols of the input.
+        obj_hashtable<func_decl> decls;
+        decl_collector dc(m_manager, false);
+        for (unsigned i = 0; i < get_num_asserted_formulas(); ++i)
+            dc.visit(get_asserted_formula(i));
+        for (unsigned i = 0; i < num_assumptions; ++i)
+            dc.visit(assumptions[i]);
+        for (unsigned i = 0; i < dc.get_num_decls(); ++i)
+            decls.insert(dc.get_func_decls()[i]);
+
+        for (unsigned i = 0; i < num_threads; ++i) {
+            ast_manager * new_m = alloc(ast_manager, m_manager, true);
+            managers.push_back(new_m);
+            smt_params * p = alloc(smt_params, m_fparams);
+            p->m_threads      = 1;
+            p->m_random_seed += i;
+            params.push_back(p);
+            context * new_ctx = alloc(context, *new_m, *p, m_params);
+            contexts.push_back(new_ctx);
+            copy(*this, *new_ctx);
+            ast_translation tr(m_manager, *new_m);
+            expr_ref_vector * new_asms = alloc(expr_ref_vector, *new_m);
+            for (unsigned j = 0; j < num_assumptions; ++j)
+                new_asms->push_back(tr(assumptions[j]));
+            asms.push_back(new_asms);
+            sl.push_child(&(new_m->limit()));
+        }
+
+        unsigned max_conflicts = m_fparams.m_max_conflicts;
+        unsigned finished_id   = UINT_MAX;
+        lbool    result        = l_undef;
+        bool     has_ex        = false;
+        std::string ex_msg;
+        // units and lemmas published by the threads, and the next entry each thread imports.
+        expr_ref_vector shared(m_manager);
+        unsigned_vector sources;
+        obj_hashtable<expr> shared_set;
+        unsigned_vector heads;
+        heads.resize(num_threads, 0);
+
+        #pragma omp parallel for num_threads(num_threads)
+        for (int i = 0; i < static_cast<int>(num_threads); ++i) {
+            ast_manager & new_m = *managers[i];
+            context & new_ctx   = *contexts[i];
+            expr_ref_vector const & new_asms = *asms[i];
+            unsigned bound         = std::max(m_fparams.m_threads_max_conflicts, 1u);
+            unsigned num_conflicts = 0;
+            try {
+                while (true) {
+                    params[i]->m_max_conflicts = std::min(bound, max_conflicts - num_conflicts);
+                    lbool r = new_ctx.check(new_asms.size(), new_asms.c_ptr());
+                    if (r != l_undef) {
+                        bool first = false;
+                        #pragma omp critical (smt_parallel)
+                        {
+                            if (finished_id == UINT_MAX) {
+                                finished_id = i;
+                                result      = r;
+                                first       = true;
+                            }
+                        }
+                        if (first) {
+                            for (unsigned j = 0; j < num_threads; ++j) {
+                                if (static_cast<unsigned>(i) != j)
+                                    managers[j]->limit().cancel();
+                            }
+                        }
+                        break;
+                    }
+                    num_conflicts += params[i]->m_max_conflicts;
+                    if (new_m.limit().get_cancel_flag() ||
+                        new_ctx.get_last_search_failure() != NUM_CONFLICTS ||
+                        num_conflicts >= max_conflicts)
+                        break;
+
+                    // publish the units and short lemmas of this thread, and import the ones of the other threads.
+                    expr_ref_vector lemmas(new_m), imported(new_m);
+                    new_ctx.get_units(lemmas);
+                    new_ctx.get_lemmas(m_fparams.m_threads_share_size, lemmas);
+                    #pragma omp critical (smt_parallel)
+                    {
+                        ast_translation tr_out(new_m, m_manager, false);
+                        for (unsigned j = 0; j < lemmas.size(); ++j) {
+                            expr_ref e(tr_out(lemmas.get(j)), m_manager);
+                            if (shared_set.contains(e) || !only_shared_symbols(decls, e))
+                                continue;
+                            shared.push_back(e);
+                            shared_set.insert(e);
+                            sources.push_back(i);
+                        }
+                        ast_translation tr_in(m_manager, new_m, false);
+                        for (unsigned j = heads[i]; j < shared.size(); ++j) {
+                            if (sources[j] != static_cast<unsigned>(i))
+                                imported.push_back(tr_in(shared.get(j)));
+                        }
+                        heads[i] = shared.size();
+                        IF_VERBOSE(2, verbose_stream() << "(smt.parallel :thread " << i << " :conflicts " << num_conflicts
+                                   << " :shared " << shared.size() << " :imported " << imported.size() << ")\n";);
+                    }
+                    for (unsigned j = 0; j < imported.size(); ++j) {
+                        if (!is_fixed(new_ctx, imported.get(j)))
+                            new_ctx.assert_expr(imported.get(j));
+                    }
+                    bound = bound > UINT_MAX / 2 ? UINT_MAX : 2 * bound;
+                }
+            }
+            catch (z3_exception & ex) {
+                #pragma omp critical (smt_parallel)
+                {
+                    if (!has_ex) {
+                        has_ex = true;
+                        ex_msg = ex.msg();
+                    }
+                }
+            }
+        }
+
+        for (unsigned i = 0; i < num_threads; ++i)
+            contexts[i]->collect_statistics(m_aux_stats);
+
+        if (finished_id == UINT_MAX) {
+            if (has_ex)
+                throw default_exception(ex_msg.c_str());
+            if (get_cancel_flag()) {
+                m_last_search_failure = CANCELED;
+            }
+            else {
+                m_last_search_failure = contexts[0]->get_last_search_failure();
+                m_unknown = contexts[0]->m_unknown;
+            }
+            return l_undef;
+        }
+
+        context & winner = *contexts[finished_id];
+        ast_translation tr(*managers[finished_id], m_manager, false);
+        m_last_search_failure = winner.get_last_search_failure();
+        if (result == l_true) {
+            model_ref mdl;
+            winner.get_model(mdl);
+            if (mdl)
+                m_model = mdl->translate(tr);
+        }
+        else {
+            m_unsat_core.reset();
+            for (unsigned i = 0; i < winner.get_unsat_core_size(); ++i)
+                m_unsat_core.push_back(tr(winner.get_unsat_core_expr(i)));
+        }
+        return result;
+    }
+
+};
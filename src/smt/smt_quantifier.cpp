@@ -130,7 +130,7 @@ namespace smt {
                         out << " #" << (*it)->get_owner_id();
                     out << "\n";
                 }
-                m_qi_queue.insert(f, pat, max_generation, min_top_generation, max_top_generation); // TODO
+                m_qi_queue.insert(f, pat, max_generation, min_top_generation, max_top_generation, used_enodes); // TODO
                 m_num_instances++;
                 return true;
             }
@@ -180,7 +180,11 @@ namespace smt {
         }
 
         void propagate() {
+            if (m_params.m_qi_profile)
+                m_qi_queue.get_profiler().start_ematching();
             m_plugin->propagate();
+            if (m_params.m_qi_profile)
+                m_qi_queue.get_profiler().stop_ematching();
             m_qi_queue.instantiate();
         }
         
@@ -220,7 +224,11 @@ namespace smt {
             if (full) {
                 IF_VERBOSE(100, verbose_stream() << "(smt.final-check \"quantifiers\")\n";);
                 final_check_status result  = m_qi_queue.final_check_eh() ? FC_DONE : FC_CONTINUE;
+                if (m_params.m_qi_profile)
+                    m_qi_queue.get_profiler().start_ematching();
                 final_check_status presult = m_plugin->final_check_eh(full);
+                if (m_params.m_qi_profile)
+                    m_qi_queue.get_profiler().stop_ematching();
                 if (presult != FC_DONE)
                     result = presult;
                 if (m_context.can_propagate())
@@ -381,6 +389,10 @@ namespace smt {
         m_imp->display_stats(out, q);
     }
 
+    void quantifier_manager::display_profile(std::ostream & out) const {
+        m_imp->m_qi_queue.get_profiler().display_json(out);
+    }
+
     ptr_vector<quantifier>::const_iterator quantifier_manager::begin_quantifiers() const { 
         return m_imp->m_quantifiers.begin(); 
     }
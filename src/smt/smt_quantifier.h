@@ -85,6 +85,10 @@ namespace smt {
         
         void display(std::ostream & out) const;
         void display_stats(std::ostream & out, quantifier * q) const;
+        /**
+           \brief Display the quantifier instantiation profile collected when qi.profile is set as JSON.
+        */
+        void display_profile(std::ostream & out) const;
 
         void collect_statistics(::statistics & st) const;
         void reset_statistics();
@@ -20,6 +20,7 @@ Notes:
 #include"smt_kernel.h"
 #include"reg_decl_plugins.h"
 #include"smt_params.h"
+#include"ast_util.h"
 
 namespace smt {
 
@@ -77,6 +78,20 @@ namespace smt {
             return m_context.check(num_assumptions, assumptions);
         }
 
+        virtual lbool get_consequences(expr_ref_vector const& asms, expr_ref_vector const& vars, expr_ref_vector& conseq) {
+            expr_ref_vector all_asms(asms);
+            for (unsigned i = 0; i < get_num_assumptions(); ++i)
+                all_asms.push_back(get_assumption(i));
+            return m_context.get_consequences(all_asms, vars, conseq);
+        }
+
+        virtual expr_ref cube(unsigned depth) {
+            expr_ref_vector lits(get_manager());
+            if (m_context.cube(depth, lits) == l_false)
+                return expr_ref(get_manager().mk_false(), get_manager());
+            return mk_and(lits);
+        }
+
         virtual void get_unsat_core(ptr_vector<expr> & r) {
             unsigned sz = m_context.get_unsat_core_size();
             for (unsigned i = 0; i < sz; i++)
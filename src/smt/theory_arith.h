@@ -48,6 +48,7 @@ namespace smt {
         unsigned m_max_min; 
         unsigned m_gb_simplify, m_gb_superpose, m_gb_compute_basis, m_gb_num_processed;
         unsigned m_nl_branching, m_nl_linear, m_nl_bounds, m_nl_cross_nested;
+        unsigned m_float_simplex, m_float_pivots;
 
         void reset() { memset(this, 0, sizeof(theory_arith_stats)); }
         theory_arith_stats() { reset(); }
@@ -765,6 +766,44 @@ namespace smt {
         bool make_feasible();
         void sign_row_conflict(theory_var x_i, bool is_below);
 
+        // -----------------------------------
+        //
+        // Floating point simplex
+        //
+        // A shadow copy of the base rows in double precision is used to
+        // search for a feasible basis. The basis is then installed in the
+        // exact tableau, and the exact simplex repairs the remaining errors.
+        // Conflicts are only detected by the exact simplex.
+        //
+        // -----------------------------------
+        typedef std::pair<theory_var, double> float_entry;
+        typedef svector<float_entry> float_row;
+        vector<float_row>       m_float_rows;
+        svector<theory_var>     m_float_base;       // per shadow row, its base variable
+        svector<int>            m_float_row_of;     // per var, the shadow row owned by the variable, or -1 if it is non base
+        vector<unsigned_vector> m_float_columns;    // per var, the shadow rows that contain the variable
+        svector<double>         m_float_value;
+        svector<double>         m_float_lower;
+        svector<double>         m_float_upper;
+        svector<char>           m_float_at_bound;   // per var, the bound (1 lower, 2 upper) at which it left the shadow basis, or 0
+        svector<int>            m_float_pos;        // temporary array used in float_pivot
+        var_heap                m_float_to_patch;
+
+        bool float_simplex_enabled() const { return m_params.m_arith_mode == AS_FLOAT_ARITH; }
+        bool float_below_lower(theory_var v) const;
+        bool float_above_upper(theory_var v) const;
+        bool float_can_increase(theory_var v) const;
+        bool float_can_decrease(theory_var v) const;
+        double get_float_coeff(unsigned r, theory_var v) const;
+        void init_float_tableau();
+        void float_update_value(theory_var v, double delta);
+        void float_del_column_entry(theory_var v, unsigned r);
+        void float_pivot(theory_var x_i, theory_var x_j, double a_ij);
+        theory_var float_select_pivot(theory_var x_i, bool is_below, bool blands_rule, double & out_a_ij);
+        bool float_make_feasible();
+        void float_basis_to_exact();
+        void make_feasible_float();
+
         // -----------------------------------
         //
         // Assert bound
@@ -1636,6 +1636,7 @@ namespace smt {
         m_var_value_table(DEFAULT_HASHTABLE_INITIAL_CAPACITY, var_value_hash(*this), var_value_eq(*this)),
         m_liberal_final_check(true),
         m_changed_assignment(false),
+        m_float_to_patch(1024),
         m_assume_eq_head(0),
         m_nl_rounds(0),
         m_nl_gb_exhausted(false),
@@ -2229,6 +2230,8 @@ namespace smt {
         m_left_basis.reset();
         m_blands_rule    = false;
         unsigned num_repeated = 0;
+        unsigned num_exact    = 0;
+        bool float_searched   = false;
         while (!m_to_patch.empty()) {
             theory_var v = select_var_to_fix();
             if (v == null_theory_var) {
@@ -2249,6 +2252,13 @@ namespace smt {
                     m_left_basis.insert(v);
                 }
             }
+            if (float_simplex_enabled() && !float_searched && ++num_exact > m_params.m_arith_float_pivot_threshold) {
+                // continue the search for a feasible basis in double precision.
+                // m_to_patch is rebuilt from the resulting assignment.
+                float_searched = true;
+                make_feasible_float();
+                continue;
+            }
             if (!make_var_feasible(v)) { 
                 TRACE("arith_make_feasible", tout << "make_feasible: unsat\n"; display(tout););
                 return false;
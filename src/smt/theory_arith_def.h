@@ -27,6 +27,7 @@ Revision History:
 #include"theory_arith_int.h"
 #include"theory_arith_eq.h"
 #include"theory_arith_nl.h"
+#include"theory_arith_float.h"
 
 #endif /* THEORY_ARITH_DEF_H_ */
 
@@ -0,0 +1,363 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    theory_arith_float.h
+
+Abstract:
+
+    Search for a feasible basis in double precision.
+
+    make_feasible switches to a shadow copy of the base rows in double
+    precision when the exact simplex needs many pivots. The shadow
+    tableau runs the same simplex algorithm on doubles. Its basis is
+    then installed in the exact tableau, the non base variables that
+    left the shadow basis are moved to the exact value of their bounds,
+    and the exact simplex takes over from there.
+
+    The shadow tableau is only used to choose pivots. The assignment,
+    the conflicts and their explanations are computed in exact
+    arithmetic.
+
+Revision History:
+
+--*/
+#ifndef THEORY_ARITH_FLOAT_H_
+#define THEORY_ARITH_FLOAT_H_
+
+#include<cmath>
+
+namespace smt {
+
+    inline double arith_to_double(rational const & n) {
+        return n.get_double();
+    }
+
+    inline double arith_to_double(inf_rational const & n) {
+        return n.get_rational().get_double();
+    }
+
+    inline double arith_to_double(inf_eps_rational<inf_rational> const & n) {
+        if (n.get_infinity().is_pos())
+            return HUGE_VAL;
+        if (n.get_infinity().is_neg())
+            return -HUGE_VAL;
+        return n.get_rational().get_double();
+    }
+
+    /**
+       \brief Tolerance used to compare values with bounds in the shadow tableau.
+    */
+    inline double float_tolerance(double bound) {
+        return 1e-9 * (1.0 + fabs(bound));
+    }
+
+    template<typename Ext>
+    bool theory_arith<Ext>::float_below_lower(theory_var v) const {
+        double l = m_float_lower[v];
+        return l != -HUGE_VAL && m_float_value[v] < l - float_tolerance(l);
+    }
+
+    template<typename Ext>
+    bool theory_arith<Ext>::float_above_upper(theory_var v) const {
+        double u = m_float_upper[v];
+        return u != HUGE_VAL && m_float_value[v] > u + float_tolerance(u);
+    }
+
+    template<typename Ext>
+    bool theory_arith<Ext>::float_can_increase(theory_var v) const {
+        double u = m_float_upper[v];
+        return u == HUGE_VAL || m_float_value[v] < u - float_tolerance(u);
+    }
+
+    template<typename Ext>
+    bool theory_arith<Ext>::float_can_decrease(theory_var v) const {
+        double l = m_float_lower[v];
+        return l == -HUGE_VAL || m_float_value[v] > l + float_tolerance(l);
+    }
+
+    template<typename Ext>
+    double theory_arith<Ext>::get_float_coeff(unsigned r, theory_var v) const {
+        float_row const & row = m_float_rows[r];
+        for (unsigned i = 0; i < row.size(); ++i) {
+            if (row[i].first == v)
+                return row[i].second;
+        }
+        UNREACHABLE();
+        return 0;
+    }
+
+    /**
+       \brief Copy the base rows, the assignment and the bounds to the shadow tableau.
+    */
+    template<typename Ext>
+    void theory_arith<Ext>::init_float_tableau() {
+        unsigned num_vars = get_num_vars();
+        m_float_rows.reset();
+        m_float_base.reset();
+        m_float_row_of.reset();
+        m_float_row_of.resize(num_vars, -1);
+        m_float_columns.reset();
+        m_float_columns.resize(num_vars);
+        m_float_value.reset();
+        m_float_lower.reset();
+        m_float_upper.reset();
+        m_float_at_bound.reset();
+        m_float_at_bound.resize(num_vars, 0);
+        m_float_pos.reset();
+        m_float_pos.resize(num_vars, -1);
+        m_float_to_patch.reset();
+        m_float_to_patch.set_bounds(num_vars);
+        for (theory_var v = 0; v < static_cast<theory_var>(num_vars); ++v) {
+            m_float_value.push_back(is_quasi_base(v) ? 0 : arith_to_double(m_value[v]));
+            m_float_lower.push_back(lower(v) ? arith_to_double(lower(v)->get_value()) : -HUGE_VAL);
+            m_float_upper.push_back(upper(v) ? arith_to_double(upper(v)->get_value()) : HUGE_VAL);
+        }
+        for (unsigned r_id = 0; r_id < m_rows.size(); ++r_id) {
+            row const & r = m_rows[r_id];
+            theory_var s  = r.get_base_var();
+            if (s == null_theory_var || !is_base(s))
+                continue;
+            unsigned fr = m_float_rows.size();
+            m_float_rows.push_back(float_row());
+            m_float_base.push_back(s);
+            m_float_row_of[s] = fr;
+            float_row & frow = m_float_rows.back();
+            typename vector<row_entry>::const_iterator it  = r.begin_entries();
+            typename vector<row_entry>::const_iterator end = r.end_entries();
+            for (; it != end; ++it) {
+                if (!it->is_dead()) {
+                    frow.push_back(float_entry(it->m_var, it->m_coeff.get_double()));
+                    m_float_columns[it->m_var].push_back(fr);
+                }
+            }
+            if (float_below_lower(s) || float_above_upper(s))
+                m_float_to_patch.insert(s);
+        }
+    }
+
+    /**
+       \brief m_float_value[v] += delta, and update the base variables of the rows that contain v.
+    */
+    template<typename Ext>
+    void theory_arith<Ext>::float_update_value(theory_var v, double delta) {
+        m_float_value[v] += delta;
+        unsigned_vector const & col = m_float_columns[v];
+        for (unsigned i = 0; i < col.size(); ++i) {
+            theory_var s = m_float_base[col[i]];
+            m_float_value[s] -= get_float_coeff(col[i], v) * delta;
+            if (!m_float_to_patch.contains(s) && (float_below_lower(s) || float_above_upper(s)))
+                m_float_to_patch.insert(s);
+        }
+    }
+
+    template<typename Ext>
+    void theory_arith<Ext>::float_del_column_entry(theory_var v, unsigned r) {
+        unsigned_vector & col = m_float_columns[v];
+        for (unsigned i = 0; i < col.size(); ++i) {
+            if (col[i] == r) {
+                col[i] = col.back();
+                col.pop_back();
+                return;
+            }
+        }
+        UNREACHABLE();
+    }
+
+    /**
+       \brief Make x_j the base variable of the shadow row owned by x_i.
+       a_ij is the coefficient of x_j in this row.
+    */
+    template<typename Ext>
+    void theory_arith<Ext>::float_pivot(theory_var x_i, theory_var x_j, double a_ij) {
+        m_stats.m_float_pivots++;
+        unsigned r_id = m_float_row_of[x_i];
+        float_row & r = m_float_rows[r_id];
+        for (unsigned i = 0; i < r.size(); ++i)
+            r[i].second /= a_ij;
+        m_float_row_of[x_i] = -1;
+        m_float_row_of[x_j] = r_id;
+        m_float_base[r_id]  = x_j;
+
+        // eliminate x_j from the other rows.
+        unsigned_vector col(m_float_columns[x_j]);
+        for (unsigned k = 0; k < col.size(); ++k) {
+            unsigned r2_id = col[k];
+            if (r2_id == r_id)
+                continue;
+            float_row & r2 = m_float_rows[r2_id];
+            for (unsigned i = 0; i < r2.size(); ++i)
+                m_float_pos[r2[i].first] = i;
+            double b = r2[m_float_pos[x_j]].second;
+            for (unsigned i = 0; i < r.size(); ++i) {
+                theory_var v = r[i].first;
+                int pos = m_float_pos[v];
+                if (pos >= 0) {
+                    r2[pos].second -= b * r[i].second;
+                }
+                else {
+                    m_float_pos[v] = r2.size();
+                    r2.push_back(float_entry(v, -b * r[i].second));
+                    m_float_columns[v].push_back(r2_id);
+                }
+            }
+            // remove x_j and the entries that were cancelled.
+            unsigned j = 0;
+            for (unsigned i = 0; i < r2.size(); ++i) {
+                theory_var v = r2[i].first;
+                m_float_pos[v] = -1;
+                if (v == x_j || (v != m_float_base[r2_id] && fabs(r2[i].second) < 1e-12)) {
+                    float_del_column_entry(v, r2_id);
+                    continue;
+                }
+                r2[j++] = r2[i];
+            }
+            r2.shrink(j);
+        }
+        SASSERT(m_float_columns[x_j].size() == 1);
+    }
+
+    /**
+       \brief Select a variable x_j in the shadow row of x_i that can be used to
+       patch the error in x_i. Prefer large coefficients for numerical stability,
+       unless Bland's rule is used.
+    */
+    template<typename Ext>
+    theory_var theory_arith<Ext>::float_select_pivot(theory_var x_i, bool is_below, bool blands_rule, double & out_a_ij) {
+        float_row const & r = m_float_rows[m_float_row_of[x_i]];
+        theory_var result   = null_theory_var;
+        double best         = 0;
+        for (unsigned i = 0; i < r.size(); ++i) {
+            theory_var x_j = r[i].first;
+            double a_ij    = r[i].second;
+            if (x_j == x_i || fabs(a_ij) < 1e-9)
+                continue;
+            // x_i = - a_ij * x_j - ..., so x_i increases when x_j moves against the sign of a_ij.
+            bool increase_x_j = is_below == (a_ij < 0);
+            if (increase_x_j ? !float_can_increase(x_j) : !float_can_decrease(x_j))
+                continue;
+            if (blands_rule ? (result == null_theory_var || x_j < result) : fabs(a_ij) > best) {
+                result    = x_j;
+                out_a_ij  = a_ij;
+                best      = fabs(a_ij);
+            }
+        }
+        return result;
+    }
+
+    /**
+       \brief Run the simplex on the shadow tableau.
+       Return true if a feasible basis was found. The search is abandoned
+       when a row cannot be repaired, the exact simplex then explains the conflict.
+    */
+    template<typename Ext>
+    bool theory_arith<Ext>::float_make_feasible() {
+        unsigned max_pivots   = 10 * m_float_rows.size() + 100;
+        unsigned num_pivots   = 0;
+        unsigned num_repeated = 0;
+        bool blands_rule      = false;
+        nat_set left_basis(m_float_value.size());
+        while (!m_float_to_patch.empty()) {
+            if (num_pivots++ >= max_pivots || get_context().get_cancel_flag())
+                return false;
+            theory_var x_i = m_float_to_patch.erase_min();
+            bool is_below;
+            if (float_below_lower(x_i))
+                is_below = true;
+            else if (float_above_upper(x_i))
+                is_below = false;
+            else
+                continue;
+            if (!blands_rule) {
+                if (left_basis.contains(x_i)) {
+                    if (++num_repeated > blands_rule_threshold())
+                        blands_rule = true;
+                }
+                else {
+                    left_basis.insert(x_i);
+                }
+            }
+            double a_ij;
+            theory_var x_j = float_select_pivot(x_i, is_below, blands_rule, a_ij);
+            if (x_j == null_theory_var) {
+                TRACE("arith_float", tout << "v" << x_i << " cannot be repaired\n";);
+                return false;
+            }
+            double new_val = is_below ? m_float_lower[x_i] : m_float_upper[x_i];
+            float_update_value(x_j, (m_float_value[x_i] - new_val) / a_ij);
+            m_float_value[x_i] = new_val;
+            float_pivot(x_i, x_j, a_ij);
+            m_float_at_bound[x_i] = is_below ? 1 : 2;
+            m_float_at_bound[x_j] = 0;
+            if (!m_float_to_patch.contains(x_j) && (float_below_lower(x_j) || float_above_upper(x_j)))
+                m_float_to_patch.insert(x_j);
+        }
+        return true;
+    }
+
+    /**
+       \brief Install the basis of the shadow tableau in the exact tableau,
+       and move the non base variables that left the shadow basis to their bounds.
+    */
+    template<typename Ext>
+    void theory_arith<Ext>::float_basis_to_exact() {
+        for (unsigned fr = 0; fr < m_float_base.size(); ++fr) {
+            theory_var x_j = m_float_base[fr];
+            if (!is_non_base(x_j))
+                continue;
+            // pick an exact row containing x_j whose base variable is not in the shadow basis.
+            theory_var x_i = null_theory_var;
+            numeral a_ij;
+            column const & c = m_columns[x_j];
+            typename svector<col_entry>::const_iterator it  = c.begin_entries();
+            typename svector<col_entry>::const_iterator end = c.end_entries();
+            for (; it != end; ++it) {
+                if (!it->is_dead()) {
+                    row const & r = m_rows[it->m_row_id];
+                    theory_var s  = r.get_base_var();
+                    if (s != null_theory_var && is_base(s) && m_float_row_of[s] == -1) {
+                        x_i  = s;
+                        a_ij = r[it->m_row_idx].m_coeff;
+                        break;
+                    }
+                }
+            }
+            // the shadow basis can be singular in exact arithmetic.
+            if (x_i != null_theory_var)
+                pivot<true>(x_i, x_j, a_ij, m_eager_gcd);
+        }
+        for (theory_var v = 0; v < static_cast<theory_var>(m_float_at_bound.size()); ++v) {
+            if (!is_non_base(v))
+                continue;
+            bound * b = 0;
+            if (m_float_at_bound[v] == 1 || below_lower(v))
+                b = lower(v);
+            else if (m_float_at_bound[v] == 2 || above_upper(v))
+                b = upper(v);
+            if (b != 0 && m_value[v] != b->get_value())
+                set_value(v, b->get_value());
+        }
+        m_to_patch.reset();
+        for (unsigned r_id = 0; r_id < m_rows.size(); ++r_id) {
+            theory_var s = m_rows[r_id].get_base_var();
+            if (s != null_theory_var && is_base(s) && (below_lower(s) || above_upper(s)))
+                m_to_patch.insert(s);
+        }
+    }
+
+    template<typename Ext>
+    void theory_arith<Ext>::make_feasible_float() {
+        m_stats.m_float_simplex++;
+        init_float_tableau();
+        bool feasible = float_make_feasible();
+        TRACE("arith_float", tout << "feasible: " << feasible << " rows: " << m_float_rows.size() << "\n";);
+        float_basis_to_exact();
+        CASSERT("arith", wf_rows());
+        CASSERT("arith", wf_columns());
+        CASSERT("arith", valid_row_assignment());
+    }
+
+};
+
+#endif /* THEORY_ARITH_FLOAT_H_ */
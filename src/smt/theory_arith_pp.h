@@ -29,6 +29,8 @@ namespace smt {
         st.update("arith conflicts", m_stats.m_conflicts);
         st.update("add rows", m_stats.m_add_rows);
         st.update("pivots", m_stats.m_pivots);
+        st.update("float simplex", m_stats.m_float_simplex);
+        st.update("float pivots", m_stats.m_float_pivots);
         st.update("assert lower", m_stats.m_assert_lower);
         st.update("assert upper", m_stats.m_assert_upper);
         st.update("assert diseq", m_stats.m_assert_diseq);
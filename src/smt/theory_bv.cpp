@@ -843,6 +843,10 @@ namespace smt {
         if (approximate_term(term)) {
             return false;
         }
+        if (m_params.m_bv_lazy_blast && is_lazy_term(term)) {
+            internalize_lazy(term);
+            return true;
+        }
         switch (term->get_decl_kind()) {
         case OP_BV_NUM:         internalize_num(term); return true;
         case OP_BADD:           internalize_add(term); return true;
@@ -1077,6 +1081,187 @@ namespace smt {
 
     }
 
+    //
+    // Lazy bit-blasting (bv.lazy_blast).
+    //
+    // Multiplication, division and remainder are internalized as
+    // uninterpreted functions: the bits of the term are fresh, and only
+    // cheap axioms relate them to the bits of the arguments. In the
+    // final check, the value of each relevant term is compared with the
+    // value of the circuit for the current values of its arguments, and
+    // the terms that do not match are bit-blasted.
+    //
+    bool theory_bv::is_lazy_term(app * n) const {
+        switch (n->get_decl_kind()) {
+        case OP_BMUL:
+        case OP_BUDIV_I:
+        case OP_BUREM_I:
+        case OP_BSDIV_I:
+        case OP_BSREM_I:
+        case OP_BSMOD_I:
+            break;
+        default:
+            return false;
+        }
+        // the circuit for a term with at most one non-numeral argument is small.
+        unsigned num_non_numerals = 0;
+        for (unsigned i = 0; i < n->get_num_args(); ++i) {
+            if (!m_util.is_numeral(n->get_arg(i)))
+                ++num_non_numerals;
+        }
+        return num_non_numerals > 1;
+    }
+
+    void theory_bv::internalize_lazy(app * n) {
+        SASSERT(!get_context().e_internalized(n));
+        context & ctx   = get_context();
+        process_args(n);
+        enode * e       = mk_enode(n);
+        theory_var v    = e->get_th_var(get_id());
+        mk_bits(v);
+        m_lazy_terms.push_back(n);
+        m_trail_stack.push(push_back_vector<theory_bv, ptr_vector<app> >(m_lazy_terms));
+        m_stats.m_num_lazy_terms++;
+        if (n->get_decl_kind() == OP_BMUL) {
+            // the lowest bit of a product is the conjunction of the lowest bits of the factors.
+            literal l0 = m_bits[v][0];
+            literal_vector & lits = m_tmp_literals;
+            lits.reset();
+            lits.push_back(l0);
+            for (unsigned i = 0; i < n->get_num_args(); ++i) {
+                literal arg0 = m_bits[get_arg_var(e, i)][0];
+                ctx.mk_th_axiom(get_id(), ~l0, arg0);
+                lits.push_back(~arg0);
+            }
+            ctx.mk_th_axiom(get_id(), lits.size(), lits.c_ptr());
+        }
+    }
+
+    /**
+       \brief Store in bits the circuit for n. The bits of the arguments of n are concatenated in arg_bits.
+    */
+    void theory_bv::mk_lazy_circuit(app * n, expr_ref_vector const & arg_bits, expr_ref_vector & bits) {
+        unsigned sz          = get_bv_size(n);
+        unsigned num_args    = n->get_num_args();
+        expr * const * args  = arg_bits.c_ptr();
+        SASSERT(arg_bits.size() == sz * num_args);
+        switch (n->get_decl_kind()) {
+        case OP_BMUL: {
+            expr_ref_vector new_bits(get_manager());
+            bits.append(sz, args + (num_args - 1) * sz);
+            for (unsigned i = num_args - 1; i > 0; ) {
+                --i;
+                new_bits.reset();
+                m_bb.mk_multiplier(sz, args + i * sz, bits.c_ptr(), new_bits);
+                bits.swap(new_bits);
+            }
+            break;
+        }
+        case OP_BUDIV_I: m_bb.mk_udiv(sz, args, args + sz, bits); break;
+        case OP_BUREM_I: m_bb.mk_urem(sz, args, args + sz, bits); break;
+        case OP_BSDIV_I: m_bb.mk_sdiv(sz, args, args + sz, bits); break;
+        case OP_BSREM_I: m_bb.mk_srem(sz, args, args + sz, bits); break;
+        case OP_BSMOD_I: m_bb.mk_smod(sz, args, args + sz, bits); break;
+        default:
+            UNREACHABLE();
+        }
+    }
+
+    /**
+       \brief Return false if the value of n in the current assignment
+       is not the value of its circuit for the values of its arguments.
+    */
+    bool theory_bv::is_lazy_term_consistent(app * n) {
+        context & ctx   = get_context();
+        ast_manager & m = get_manager();
+        enode * e       = ctx.get_enode(n);
+        expr_ref_vector arg_bits(m), bits(m);
+        for (unsigned i = 0; i < n->get_num_args(); ++i) {
+            literal_vector const & lits = m_bits[get_arg_var(e, i)];
+            for (unsigned j = 0; j < lits.size(); ++j) {
+                lbool val = ctx.get_assignment(lits[j]);
+                if (val == l_undef)
+                    return true;
+                arg_bits.push_back(val == l_true ? m.mk_true() : m.mk_false());
+            }
+        }
+        // the circuit evaluates to constants for constant inputs.
+        mk_lazy_circuit(n, arg_bits, bits);
+        literal_vector const & lits = m_bits[e->get_th_var(get_id())];
+        for (unsigned i = 0; i < lits.size(); ++i) {
+            switch (ctx.get_assignment(lits[i])) {
+            case l_true:  if (!m.is_true(bits.get(i))) return false; break;
+            case l_false: if (!m.is_false(bits.get(i))) return false; break;
+            case l_undef: break;
+            }
+        }
+        return true;
+    }
+
+    void theory_bv::blast_lazy_term(app * n) {
+        context & ctx   = get_context();
+        ast_manager & m = get_manager();
+        enode * e       = ctx.get_enode(n);
+        theory_var v    = e->get_th_var(get_id());
+        TRACE("bv", tout << "blasting: " << mk_bounded_pp(n, m) << "\n";);
+        expr_ref_vector arg_bits(m), bits(m);
+        for (unsigned i = 0; i < n->get_num_args(); ++i)
+            get_arg_bits(e, i, arg_bits);
+        mk_lazy_circuit(n, arg_bits, bits);
+        for (unsigned i = 0; i < bits.size(); ++i) {
+            expr_ref s_bit(m);
+            simplify_bit(bits.get(i), s_bit);
+            ctx.internalize(s_bit, true);
+            literal l   = ctx.get_literal(s_bit);
+            literal bit = m_bits[v][i];
+            ctx.mark_as_relevant(l);
+            mk_lazy_lemma(~bit, l);
+            mk_lazy_lemma(bit, ~l);
+        }
+        m_stats.m_num_lazy_blasts++;
+    }
+
+    /**
+       \brief The circuit of a lazy term is added as lemmas, so that it survives backtracking.
+       A bit of the circuit may be constant, and then the lemma is a unit that is asserted
+       as an axiom. It is lost on backtracking, and check_lazy_terms adds it again if needed.
+    */
+    void theory_bv::mk_lazy_lemma(literal l1, literal l2) {
+        context & ctx      = get_context();
+        if (l1 == true_literal || l2 == true_literal)
+            return;
+        if (l1 == false_literal || l2 == false_literal) {
+            literal l = l1 == false_literal ? l2 : l1;
+            ctx.mk_th_axiom(get_id(), 1, &l);
+            return;
+        }
+        literal lits[2]    = { l1, l2 };
+        justification * js = 0;
+        if (get_manager().proofs_enabled())
+            js = alloc(theory_lemma_justification, get_id(), ctx, 2, lits);
+        ctx.mk_clause(2, lits, js, CLS_AUX_LEMMA, 0);
+    }
+
+    /**
+       \brief Bit-blast the relevant lazy terms whose value is inconsistent.
+       Return true if all lazy terms are consistent.
+
+       Terms that were already bit-blasted are also checked, because
+       the lemmas of their circuit may have been garbage collected.
+    */
+    bool theory_bv::check_lazy_terms() {
+        context & ctx = get_context();
+        bool consistent = true;
+        for (unsigned i = 0; i < m_lazy_terms.size(); ++i) {
+            app * n = m_lazy_terms[i];
+            if (!ctx.is_relevant(n) || is_lazy_term_consistent(n))
+                continue;
+            blast_lazy_term(n);
+            consistent = false;
+        }
+        return consistent;
+    }
+
     void theory_bv::apply_sort_cnstr(enode * n, sort * s) {
         if (!is_attached_to_var(n) && !approximate_term(n->get_owner())) {
             theory_var v = mk_var(n);
@@ -1316,6 +1501,9 @@ namespace smt {
 
     final_check_status theory_bv::final_check_eh() {
         SASSERT(check_invariant());
+        if (!check_lazy_terms()) {
+            return FC_CONTINUE;
+        }
         if (m_approximates_large_bvs) {
             return FC_GIVEUP;
         }
@@ -1326,6 +1514,7 @@ namespace smt {
         pop_scope_eh(m_trail_stack.get_num_scopes());
         m_bool_var2atom.reset();
         m_fixed_var_table.reset();
+        m_lazy_terms.reset();
         theory::reset_eh();
     }
 
@@ -1648,6 +1837,8 @@ namespace smt {
         st.update("bv bit2core", m_stats.m_num_bit2core);
         st.update("bv->core eq", m_stats.m_num_th2core_eq);
         st.update("bv dynamic eqs", m_stats.m_num_eq_dynamic);
+        st.update("bv lazy terms", m_stats.m_num_lazy_terms);
+        st.update("bv lazy blasts", m_stats.m_num_lazy_blasts);
     }
 
 #ifdef Z3DEBUG
@@ -35,6 +35,7 @@ namespace smt {
     struct theory_bv_stats {
         unsigned   m_num_diseq_static, m_num_diseq_dynamic, m_num_bit2core, m_num_th2core_eq, m_num_conflicts;
         unsigned   m_num_eq_dynamic;
+        unsigned   m_num_lazy_terms, m_num_lazy_blasts;
         void reset() { memset(this, 0, sizeof(theory_bv_stats)); }
         theory_bv_stats() { reset(); }
     };
@@ -131,6 +132,7 @@ namespace smt {
         literal_vector           m_tmp_literals;
         svector<var_pos>         m_prop_queue;
         bool                     m_approximates_large_bvs;
+        ptr_vector<app>          m_lazy_terms;   // terms that are not bit-blasted yet (bv.lazy_blast).
 
         theory_var find(theory_var v) const { return m_find.find(v); }
         theory_var next(theory_var v) const { return m_find.next(v); }
@@ -208,6 +210,14 @@ namespace smt {
 
         bool approximate_term(app* n);
 
+        bool is_lazy_term(app * n) const;
+        void internalize_lazy(app * n);
+        void mk_lazy_circuit(app * n, expr_ref_vector const & arg_bits, expr_ref_vector & bits);
+        bool is_lazy_term_consistent(app * n);
+        void blast_lazy_term(app * n);
+        void mk_lazy_lemma(literal l1, literal l2);
+        bool check_lazy_terms();
+
         template<bool Signed>
         void internalize_le(app * atom);
         bool internalize_xor3(app * n, bool gate_ctx);
@@ -189,6 +189,22 @@ public:
         return m_solver1->get_scope_level();
     }
 
+    virtual lbool get_consequences(expr_ref_vector const& asms, expr_ref_vector const& vars, expr_ref_vector& consequences) {
+        // consequences are computed by a sequence of incremental checks.
+        m_check_sat_executed  = true;        
+        m_use_solver1_results = false;
+        switch_inc_mode();
+        return m_solver2->get_consequences(asms, vars, consequences);
+    }
+
+    virtual expr_ref cube(unsigned depth) {
+        // the cubes are enumerated incrementally.
+        m_check_sat_executed  = true;
+        m_use_solver1_results = false;
+        switch_inc_mode();
+        return m_solver2->cube(depth);
+    }
+
     virtual lbool check_sat(unsigned num_assumptions, expr * const * assumptions) {
         m_check_sat_executed  = true;        
         m_use_solver1_results = false;
@@ -17,6 +17,7 @@ Notes:
 
 --*/
 #include"solver.h"
+#include"ast_util.h"
 
 unsigned solver::get_num_assertions() const {
     NOT_IMPLEMENTED_YET();
@@ -32,3 +33,69 @@ void solver::display(std::ostream & out) const {
     out << "(solver)";
 }
 
+
+expr_ref solver::cube(unsigned depth) {
+    ast_manager& m = get_manager();
+    return expr_ref(m.mk_true(), m);
+}
+
+lbool solver::get_consequences(expr_ref_vector const& asms, expr_ref_vector const& vars, expr_ref_vector& consequences) {
+    ast_manager& m = get_manager();
+    lbool is_sat = check_sat(asms.size(), asms.c_ptr());
+    if (is_sat != l_true) {
+        return is_sat;
+    }
+    model_ref mdl;
+    get_model(mdl);
+    expr_ref_vector lits(m);
+    for (unsigned i = 0; i < vars.size(); ++i) {
+        expr* v = vars[i];
+        expr_ref val(m);
+        if (!mdl || !mdl->eval(v, val, true)) {
+            continue;
+        }
+        if (m.is_bool(v)) {
+            if (m.is_true(val)) lits.push_back(v);
+            else if (m.is_false(val)) lits.push_back(m.mk_not(v));
+        }
+        else if (!m.is_uninterp(m.get_sort(v)) && m.is_value(val)) {
+            lits.push_back(m.mk_eq(v, val));
+        }
+    }
+    while (!lits.empty()) {
+        expr_ref lit(lits.back(), m);
+        lits.pop_back();
+        {
+            scoped_push _push(*this);
+            assert_expr(mk_not(m, lit));
+            is_sat = check_sat(asms.size(), asms.c_ptr());
+            if (is_sat == l_true) {
+                get_model(mdl);
+            }
+            else if (is_sat == l_false) {
+                // solvers that do not produce cores make the value depend on all assumptions.
+                ptr_vector<expr> core;
+                get_unsat_core(core);
+                expr_ref_vector ante(m);
+                ante.append(core.size(), core.c_ptr());
+                if (core.empty()) ante.append(asms);
+                consequences.push_back(m.mk_implies(mk_and(ante), lit));
+            }
+        }
+        if (is_sat == l_undef) {
+            return l_undef;
+        }
+        if (is_sat == l_true) {
+            // the candidates that are false in the new model are not implied.
+            unsigned j = 0;
+            for (unsigned i = 0; i < lits.size(); ++i) {
+                expr_ref val(m);
+                if (mdl && mdl->eval(lits.get(i), val, true) && m.is_true(val)) {
+                    lits.set(j++, lits.get(i));
+                }
+            }
+            lits.shrink(j);
+        }
+    }
+    return l_true;
+}
@@ -108,6 +108,29 @@ public:
     */
     virtual lbool check_sat(unsigned num_assumptions, expr * const * assumptions) = 0;
 
+    /**
+       \brief Find the values of the variables in vars that are implied by the assertions and the assumptions.
+       For each such variable v, an implication (=> (and a_1 ... a_k) (= v val)) is added to consequences, 
+       where a_1 ... a_k are assumptions that imply the value val of v. For Boolean variables the
+       implied literal is v or (not v). Variables whose value is not implied are omitted.
+
+       The result is l_false if the assertions and the assumptions are unsatisfiable.
+
+       The default implementation uses a check_sat call for every candidate value that is not
+       ruled out by the models of the previous calls.
+    */
+    virtual lbool get_consequences(expr_ref_vector const& asms, expr_ref_vector const& vars, expr_ref_vector& consequences);
+
+    /**
+       \brief Return a cube, a conjunction of at most depth literals, that splits the search space.
+       The result is false if the assertions are unsatisfiable, and true if the solver does 
+       not split the assertions. Asserting the negation of each cube before asking for the 
+       next one enumerates a partition of the problem: the assertions are satisfiable iff
+       the conjunction of the assertions and one of the cubes is satisfiable.
+
+       The default implementation does not split the assertions.
+    */
+    virtual expr_ref cube(unsigned depth);
 
     /**
        \brief Set a progress callback procedure that is invoked by this solver during check_sat.
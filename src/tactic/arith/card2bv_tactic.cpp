@@ -44,9 +44,21 @@ namespace pb {
         bv(m),
         m_sort(*this),
         m_lemmas(m),
-        m_trail(m)
+        m_trail(m),
+        m_keep_cardinality_constraints(false)
     {}
 
+    /**
+       \brief Return true if the constraint f is kept for a solver that supports
+       cardinality and pseudo-Boolean constraints natively.
+    */
+    bool card2bv_rewriter::keep(func_decl* f) const {
+        return
+            m_keep_cardinality_constraints &&
+            (pb.is_at_most_k(f) || pb.is_at_least_k(f) || pb.is_le(f) || pb.is_ge(f) || pb.is_eq(f)) &&
+            pb.has_unsigned_coefficients(f);
+    }
+
     void card2bv_rewriter::mk_assert(func_decl * f, unsigned sz, expr * const* args, expr_ref & result, expr_ref_vector& lemmas) {
         m_lemmas.reset();
         SASSERT(f->get_family_id() == pb.get_family_id());
@@ -56,6 +68,9 @@ namespace pb {
         else if (is_and(f)) {
             result = m.mk_and(sz, args);
         }
+        else if (keep(f)) {
+            result = m.mk_app(f, sz, args);
+        }
         else if (pb.is_eq(f) && pb.get_k(f).is_unsigned() && pb.has_unit_coefficients(f)) {
             result = m_sort.eq(pb.get_k(f).get_unsigned(), sz, args);
         }
@@ -116,6 +131,9 @@ namespace pb {
                 result = m.mk_and(sz, args);
                 return BR_DONE;
             }
+            if (keep(f)) {
+                return BR_FAILED;
+            }
             br_status st = mk_shannon(f, sz, args, result);
             if (st == BR_FAILED) {
                 mk_bv(f, sz, args, result);
@@ -446,6 +464,7 @@ public:
         m_params(p),
         m_rw1(m),
         m_rw2(m) {
+        updt_params(p);
     }
 
     virtual tactic * translate(ast_manager & m) {
@@ -457,9 +476,11 @@ public:
 
     virtual void updt_params(params_ref const & p) {
         m_params = p;
+        m_rw2.set_keep_cardinality_constraints(p.get_bool("keep_cardinality_constraints", false));
     }
 
     virtual void collect_param_descrs(param_descrs & r) {  
+        r.insert("keep_cardinality_constraints", CPK_BOOL, "(default: false) retain cardinality and pseudo-Boolean constraints whose coefficients fit in unsigned integers.");
     }
 
     
@@ -44,8 +44,10 @@ namespace pb {
         psort_nw<card2bv_rewriter> m_sort;
         expr_ref_vector m_lemmas;
         expr_ref_vector m_trail;
+        bool            m_keep_cardinality_constraints;
 
         unsigned get_num_bits(func_decl* f);
+        bool keep(func_decl* f) const;
         void mk_bv(func_decl * f, unsigned sz, expr * const* args, expr_ref & result);
         br_status mk_shannon(func_decl * f, unsigned sz, expr * const* args, expr_ref & result);
         expr* negate(expr* e);
@@ -55,6 +57,7 @@ namespace pb {
 
     public:
         card2bv_rewriter(ast_manager& m);
+        void set_keep_cardinality_constraints(bool f) { m_keep_cardinality_constraints = f; }
         br_status mk_app_core(func_decl * f, unsigned sz, expr * const* args, expr_ref & result);
         void mk_assert(func_decl * f, unsigned sz, expr * const* args, expr_ref & result, expr_ref_vector& lemmas);
 
@@ -95,6 +98,8 @@ namespace pb {
         
         void rewrite(expr* e, expr_ref& result);
 
+        void set_keep_cardinality_constraints(bool f) { m_cfg.m_r.set_keep_cardinality_constraints(f); }
+
         expr_ref_vector& lemmas() { return m_lemmas; }
     };
 };
@@ -0,0 +1,130 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    inc_sat_solver.cpp
+
+Abstract:
+
+    Replay an incremental SMT2 trace with the incremental SAT solver
+    and report the latency of each check-sat.
+
+    test inc_sat_solver               replays a generated bit-vector trace.
+    test inc_sat_solver_file <file>   replays a given SMT2 file.
+
+Revision History:
+
+--*/
+#include<sstream>
+#include<fstream>
+#include<iomanip>
+#include<vector>
+#include"cmd_context.h"
+#include"smt2parser.h"
+#include"inc_sat_solver.h"
+#include"stopwatch.h"
+
+class inc_sat_solver_factory : public solver_factory {
+public:
+    virtual solver * operator()(ast_manager & m, params_ref const & p, bool proofs_enabled, bool models_enabled, bool unsat_core_enabled, symbol const & logic) {
+        return mk_inc_sat_solver(m, p);
+    }
+};
+
+// split the trace into top-level commands, skipping comments, strings and quoted symbols.
+static void split_commands(std::string const & trace, std::vector<std::string>& cmds) {
+    unsigned depth = 0;
+    unsigned start = 0;
+    for (unsigned i = 0; i < trace.size(); ++i) {
+        char c = trace[i];
+        switch (c) {
+        case ';':
+            while (i < trace.size() && trace[i] != '\n') ++i;
+            break;
+        case '"':
+            for (++i; i < trace.size(); ++i) {
+                if (trace[i] == '"' && (i + 1 == trace.size() || trace[i + 1] != '"')) break;
+                if (trace[i] == '"') ++i;
+            }
+            break;
+        case '|':
+            for (++i; i < trace.size() && trace[i] != '|'; ++i);
+            break;
+        case '(':
+            if (depth++ == 0) start = i;
+            break;
+        case ')':
+            if (depth > 0 && --depth == 0) cmds.push_back(trace.substr(start, i - start + 1));
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+static void replay_trace(std::string const & trace) {
+    cmd_context ctx;
+    ctx.set_solver_factory(alloc(inc_sat_solver_factory));
+    std::vector<std::string> cmds;
+    split_commands(trace, cmds);
+    unsigned num_checks = 0;
+    double total = 0, max_time = 0;
+    for (unsigned i = 0; i < cmds.size(); ++i) {
+        bool is_check = cmds[i].compare(0, 10, "(check-sat") == 0;
+        std::istringstream in(cmds[i]);
+        stopwatch sw;
+        sw.start();
+        VERIFY(parse_smt2_commands(ctx, in));
+        sw.stop();
+        if (!is_check)
+            continue;
+        double ms = sw.get_seconds() * 1000;
+        check_sat_result * r = ctx.get_check_sat_result();
+        std::cout << "check " << num_checks << ": " << (r ? r->status() : l_undef)
+                  << " " << std::fixed << std::setprecision(2) << ms << " ms\n";
+        ++num_checks;
+        total += ms;
+        max_time = std::max(max_time, ms);
+    }
+    if (num_checks > 0) {
+        std::cout << "checks: " << num_checks << " total: " << total << " ms mean: " << total / num_checks
+                  << " ms max: " << max_time << " ms\n";
+    }
+}
+
+// x*y = c under a growing set of constraints: each round adds a permanent
+// constraint and checks a few scoped variations of it.
+static void mk_trace(std::ostream & out, unsigned rounds) {
+    out << "(set-logic QF_BV)\n";
+    out << "(declare-const x (_ BitVec 16))\n";
+    out << "(declare-const y (_ BitVec 16))\n";
+    out << "(assert (= (bvmul x y) #x4d2b))\n";
+    out << "(assert (bvugt x #x0001))\n";
+    out << "(assert (bvugt y #x0001))\n";
+    for (unsigned i = 0; i < rounds; ++i) {
+        out << "(push 1)\n";
+        out << "(assert (bvult x (_ bv" << (2 + i) << " 16)))\n";
+        out << "(check-sat)\n";
+        out << "(pop 1)\n";
+        out << "(declare-const b" << i << " Bool)\n";
+        out << "(assert (=> b" << i << " (bvuge (bvadd x y) (_ bv" << (10 * i) << " 16))))\n";
+        out << "(check-sat b" << i << ")\n";
+    }
+}
+
+void tst_inc_sat_solver() {
+    std::ostringstream out;
+    mk_trace(out, 10);
+    replay_trace(out.str());
+}
+
+void tst_inc_sat_solver_file(char ** argv, int argc, int & i) {
+    if (i + 1 < argc) {
+        std::ifstream in(argv[i + 1]);
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+        replay_trace(buffer.str());
+        i++;
+    }
+}
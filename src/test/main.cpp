@@ -224,6 +224,13 @@ int main(int argc, char ** argv) {
     TST(theory_pb);
     TST(simplex);
     TST(sat_user_scope);
+    TST(sat_drat);
+    TST_ARGV(sat_drat_file);
+    TST(sat_lookahead);
+    TST(sat_xor);
+    TST(sat_card);
+    TST(inc_sat_solver);
+    TST_ARGV(inc_sat_solver_file);
     TST(pdr);
     TST_ARGV(ddnf);
     TST(model_evaluator);
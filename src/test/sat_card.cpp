@@ -0,0 +1,150 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    sat_card.cpp
+
+Abstract:
+
+    Test the cardinality and pseudo-Boolean constraints of the SAT solver
+    against exhaustive enumeration on small random problems,
+    with and without assumptions.
+
+Revision History:
+
+--*/
+#include"sat_solver.h"
+#include"util.h"
+
+struct pb_cnstr {
+    sat::literal   m_lit;       // null_literal for unconditional constraints
+    sat::literal_vector m_lits;
+    unsigned_vector m_coeffs;
+    unsigned        m_k;
+};
+
+static bool is_true(sat::literal l, unsigned mask) {
+    return (((mask >> l.var()) & 1) != 0) != l.sign();
+}
+
+static bool is_sat(vector<pb_cnstr> const & cs, vector<sat::literal_vector> const & clauses, sat::literal_vector const & asms, unsigned mask) {
+    for (unsigned i = 0; i < asms.size(); ++i) {
+        if (!is_true(asms[i], mask))
+            return false;
+    }
+    for (unsigned i = 0; i < cs.size(); ++i) {
+        pb_cnstr const & c = cs[i];
+        unsigned sum = 0;
+        for (unsigned j = 0; j < c.m_lits.size(); ++j) {
+            if (is_true(c.m_lits[j], mask))
+                sum += c.m_coeffs[j];
+        }
+        bool holds = sum >= c.m_k;
+        if (c.m_lit == sat::null_literal ? !holds : holds != is_true(c.m_lit, mask))
+            return false;
+    }
+    for (unsigned i = 0; i < clauses.size(); ++i) {
+        bool holds = false;
+        for (unsigned j = 0; !holds && j < clauses[i].size(); ++j)
+            holds = is_true(clauses[i][j], mask);
+        if (!holds)
+            return false;
+    }
+    return true;
+}
+
+static lbool brute_force(unsigned num_vars, vector<pb_cnstr> const & cs, vector<sat::literal_vector> const & clauses, sat::literal_vector const & asms) {
+    for (unsigned mask = 0; mask < (1u << num_vars); ++mask) {
+        if (is_sat(cs, clauses, asms, mask))
+            return l_true;
+    }
+    return l_false;
+}
+
+static void mk_pb(random_gen & r, unsigned num_vars, pb_cnstr & c) {
+    unsigned sz = 2 + r(5);
+    unsigned sum = 0;
+    bool is_card = r(2) == 0;
+    for (unsigned j = 0; j < sz; ++j) {
+        c.m_lits.push_back(sat::literal(r(num_vars), r(2) == 0));
+        c.m_coeffs.push_back(is_card ? 1 : 1 + r(4));
+        sum += c.m_coeffs.back();
+    }
+    c.m_k = r(sum + 2);
+    c.m_lit = r(3) == 0 ? sat::literal(r(num_vars), r(2) == 0) : sat::null_literal;
+}
+
+static void check(random_gen & r, sat::solver & s, unsigned num_vars, vector<pb_cnstr> const & cs, vector<sat::literal_vector> const & clauses) {
+    sat::literal_vector asms;
+    unsigned num_asms = r(4);
+    for (unsigned i = 0; i < num_asms; ++i)
+        asms.push_back(sat::literal(r(num_vars), r(2) == 0));
+    lbool expected = brute_force(num_vars, cs, clauses, asms);
+    lbool result = s.check(asms.size(), asms.c_ptr());
+    std::cout << expected << " " << result << "\n";
+    ENSURE(expected == result);
+    if (result == l_true) {
+        unsigned mask = 0;
+        for (unsigned v = 0; v < num_vars; ++v) {
+            if (s.get_model()[v] == l_true)
+                mask |= 1u << v;
+        }
+        ENSURE(is_sat(cs, clauses, asms, mask));
+    }
+    else if (!asms.empty()) {
+        // the core is an unsatisfiable subset of the assumptions.
+        sat::literal_vector const & core = s.get_core();
+        for (unsigned i = 0; i < core.size(); ++i)
+            ENSURE(asms.contains(core[i]));
+        ENSURE(brute_force(num_vars, cs, clauses, core) == l_false);
+    }
+}
+
+static void tst_card(unsigned seed, unsigned num_vars) {
+    random_gen r(seed);
+    reslimit rlim;
+    params_ref p;
+    p.set_bool("cardinality_solver", true);
+    sat::solver s(p, rlim, 0);
+    while (s.num_vars() < num_vars) {
+        s.mk_var(true, true);
+    }
+    sat::card_solver & card = *s.get_card_solver();
+    vector<pb_cnstr> cs;
+    vector<sat::literal_vector> clauses;
+    unsigned num_cs = 1 + r(4);
+    for (unsigned i = 0; i < num_cs; ++i) {
+        cs.push_back(pb_cnstr());
+        pb_cnstr & c = cs.back();
+        mk_pb(r, num_vars, c);
+        card.add_pb_ge(c.m_lit, c.m_lits.size(), c.m_lits.c_ptr(), c.m_coeffs.c_ptr(), c.m_k);
+    }
+    unsigned num_clauses = r(4);
+    for (unsigned i = 0; i < num_clauses; ++i) {
+        clauses.push_back(sat::literal_vector());
+        for (unsigned j = 0; j < 2; ++j)
+            clauses.back().push_back(sat::literal(r(num_vars), r(2) == 0));
+        s.mk_clause(clauses.back().size(), clauses.back().c_ptr());
+    }
+    std::cout << "seed " << seed << ": ";
+    check(r, s, num_vars, cs, clauses);
+    check(r, s, num_vars, cs, clauses);
+
+    // the constraints of a user scope are removed when the scope is popped.
+    s.user_push();
+    cs.push_back(pb_cnstr());
+    mk_pb(r, num_vars, cs.back());
+    pb_cnstr const & c = cs.back();
+    card.add_pb_ge(c.m_lit, c.m_lits.size(), c.m_lits.c_ptr(), c.m_coeffs.c_ptr(), c.m_k);
+    check(r, s, num_vars, cs, clauses);
+    s.user_pop(1);
+    cs.pop_back();
+    check(r, s, num_vars, cs, clauses);
+}
+
+void tst_sat_card() {
+    for (unsigned seed = 0; seed < 400; ++seed) {
+        tst_card(seed, 8);
+    }
+}
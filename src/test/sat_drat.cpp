@@ -0,0 +1,99 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    sat_drat.cpp
+
+Abstract:
+
+    Measure the overhead of DRAT proof generation in the SAT solver.
+    Instances are read with the DIMACS parser used by the shell frontend.
+
+    test sat_drat               runs a pigeon-hole instance.
+    test sat_drat_file <file>   runs a given DIMACS file.
+
+Revision History:
+
+--*/
+#include<sstream>
+#include<fstream>
+#include"sat_solver.h"
+#include"dimacs.h"
+#include"stopwatch.h"
+
+static void mk_pigeon_hole(std::ostream & out, unsigned n) {
+    // n+1 pigeons in n holes, variable p*n + h + 1 says that pigeon p sits in hole h.
+    unsigned num_vars = (n + 1) * n;
+    unsigned num_clauses = (n + 1) + n * (n + 1) * n / 2;
+    out << "p cnf " << num_vars << " " << num_clauses << "\n";
+    for (unsigned p = 0; p <= n; ++p) {
+        for (unsigned h = 0; h < n; ++h) {
+            out << (p * n + h + 1) << " ";
+        }
+        out << "0\n";
+    }
+    for (unsigned h = 0; h < n; ++h) {
+        for (unsigned p1 = 0; p1 <= n; ++p1) {
+            for (unsigned p2 = p1 + 1; p2 <= n; ++p2) {
+                out << "-" << (p1 * n + h + 1) << " -" << (p2 * n + h + 1) << " 0\n";
+            }
+        }
+    }
+}
+
+static lbool run_dimacs(std::string const & dimacs, char const * drat_file, bool binary, double & time) {
+    params_ref p;
+    if (drat_file) {
+        p.set_sym("drat.file", symbol(drat_file));
+        p.set_bool("drat.binary", binary);
+    }
+    reslimit limit;
+    sat::solver s(p, limit, 0);
+    std::istringstream in(dimacs);
+    parse_dimacs(in, s);
+    stopwatch sw;
+    sw.start();
+    lbool r = s.check();
+    sw.stop();
+    time = sw.get_seconds();
+    return r;
+}
+
+static unsigned long long file_size(char const * file_name) {
+    std::ifstream in(file_name, std::ios_base::binary | std::ios_base::ate);
+    return in ? static_cast<unsigned long long>(in.tellg()) : 0;
+}
+
+static void bench_drat(std::string const & dimacs) {
+    char const * drat_file = "sat_drat_test.drat";
+    double t0, t1, t2;
+    lbool r0 = run_dimacs(dimacs, 0, false, t0);
+    lbool r1 = run_dimacs(dimacs, drat_file, false, t1);
+    unsigned long long sz1 = file_size(drat_file);
+    lbool r2 = run_dimacs(dimacs, drat_file, true, t2);
+    unsigned long long sz2 = file_size(drat_file);
+    std::cout << "result: " << r0 << "\n";
+    std::cout << "no proof:    " << t0 << "s\n";
+    std::cout << "drat:        " << t1 << "s " << sz1 << " bytes\n";
+    std::cout << "binary drat: " << t2 << "s " << sz2 << " bytes\n";
+    ENSURE(r0 == r1 && r0 == r2);
+    ENSURE(r0 != l_false || (sz1 > 0 && sz2 > 0));
+    remove(drat_file);
+}
+
+void tst_sat_drat() {
+    std::ostringstream out;
+    mk_pigeon_hole(out, 6);
+    bench_drat(out.str());
+}
+
+void tst_sat_drat_file(char ** argv, int argc, int & i) {
+    if (i + 1 < argc) {
+        std::ifstream in(argv[i + 1]);
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+        bench_drat(buffer.str());
+        i++;
+    }
+}
@@ -0,0 +1,76 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    sat_lookahead.cpp
+
+Abstract:
+
+    Test cube and conquer against plain CDCL on random 3-SAT instances.
+
+Revision History:
+
+--*/
+#include"sat_solver.h"
+#include"sat_lookahead.h"
+#include"util.h"
+
+static void add_random_clauses(sat::solver & s, random_gen & r, unsigned num_vars, unsigned num_clauses) {
+    while (s.num_vars() <= num_vars) {
+        s.mk_var();
+    }
+    sat::literal_vector lits;
+    for (unsigned i = 0; i < num_clauses; ++i) {
+        lits.reset();
+        for (unsigned j = 0; j < 3; ++j) {
+            lits.push_back(sat::literal(r(num_vars) + 1, r(2) == 0));
+        }
+        s.mk_clause(lits.size(), lits.c_ptr());
+    }
+}
+
+static void tst_cube_and_conquer(unsigned seed, unsigned num_vars, unsigned num_clauses) {
+    reslimit rlim;
+    params_ref p;
+    sat::solver s1(p, rlim, 0);
+    random_gen r1(seed);
+    add_random_clauses(s1, r1, num_vars, num_clauses);
+    lbool expected = s1.check();
+
+    p.set_uint("lookahead.cube_depth", 4);
+    p.set_uint("threads", 2);
+    sat::solver s2(p, rlim, 0);
+    random_gen r2(seed);
+    add_random_clauses(s2, r2, num_vars, num_clauses);
+
+    vector<sat::literal_vector> cubes;
+    {
+        sat::lookahead lh(s2);
+        lh.get_cubes(cubes);
+    }
+    lbool result = s2.check();
+    std::cout << "seed: " << seed << " cubes: " << cubes.size() << " result: " << result << "\n";
+    ENSURE(result == expected);
+    ENSURE(result != l_false || s2.inconsistent());
+    if (result == l_true) {
+        ENSURE(cubes.size() > 0);
+        sat::model const & m = s2.get_model();
+        // the model satisfies the original clauses.
+        random_gen r3(seed);
+        for (unsigned i = 0; i < num_clauses; ++i) {
+            bool sat = false;
+            for (unsigned j = 0; j < 3; ++j) {
+                sat::literal l(r3(num_vars) + 1, r3(2) == 0);
+                sat |= value_at(l, m) == l_true;
+            }
+            ENSURE(sat);
+        }
+    }
+}
+
+void tst_sat_lookahead() {
+    for (unsigned seed = 0; seed < 10; ++seed) {
+        tst_cube_and_conquer(seed, 60, 250 + 5 * seed);
+    }
+}
@@ -0,0 +1,96 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    sat_xor.cpp
+
+Abstract:
+
+    Test Gauss-Jordan elimination of XOR constraints against plain CDCL
+    on random XOR systems mixed with random clauses.
+
+Revision History:
+
+--*/
+#include"sat_solver.h"
+#include"util.h"
+
+struct xor_cnstr {
+    sat::bool_var_vector m_vars;
+    bool                 m_parity;
+};
+
+static void mk_xor_clauses(sat::solver & s, xor_cnstr const & x) {
+    unsigned sz = x.m_vars.size();
+    sat::literal_vector lits;
+    for (unsigned mask = 0; mask < (1u << sz); ++mask) {
+        // exclude the assignments with the wrong parity.
+        if (((get_num_1bits(mask) & 1) != 0) == x.m_parity)
+            continue;
+        lits.reset();
+        for (unsigned i = 0; i < sz; ++i)
+            lits.push_back(sat::literal(x.m_vars[i], (mask & (1u << i)) != 0));
+        s.mk_clause(lits.size(), lits.c_ptr());
+    }
+}
+
+static void mk_problem(sat::solver & s, unsigned seed, unsigned num_vars, unsigned num_xors, unsigned num_clauses, vector<xor_cnstr> & xors) {
+    random_gen r(seed);
+    while (s.num_vars() < num_vars) {
+        s.mk_var();
+    }
+    xors.reset();
+    for (unsigned i = 0; i < num_xors; ++i) {
+        xors.push_back(xor_cnstr());
+        xor_cnstr & x = xors.back();
+        unsigned sz = 3 + r(2);
+        while (x.m_vars.size() < sz) {
+            sat::bool_var v = r(num_vars);
+            if (!x.m_vars.contains(v))
+                x.m_vars.push_back(v);
+        }
+        x.m_parity = r(2) == 0;
+        mk_xor_clauses(s, x);
+    }
+    sat::literal_vector lits;
+    for (unsigned i = 0; i < num_clauses; ++i) {
+        lits.reset();
+        for (unsigned j = 0; j < 3; ++j) {
+            lits.push_back(sat::literal(r(num_vars), r(2) == 0));
+        }
+        s.mk_clause(lits.size(), lits.c_ptr());
+    }
+}
+
+static void tst_xor(unsigned seed, unsigned num_vars, unsigned num_xors, unsigned num_clauses) {
+    reslimit rlim;
+    params_ref p;
+    vector<xor_cnstr> xors;
+    sat::solver s1(p, rlim, 0);
+    mk_problem(s1, seed, num_vars, num_xors, num_clauses, xors);
+    lbool expected = s1.check();
+
+    p.set_bool("xor_solver", true);
+    sat::solver s2(p, rlim, 0);
+    mk_problem(s2, seed, num_vars, num_xors, num_clauses, xors);
+    lbool result = s2.check();
+    std::cout << "seed " << seed << ": " << expected << " " << result << "\n";
+    ENSURE(expected == result);
+    if (result == l_true) {
+        sat::model const & m = s2.get_model();
+        for (unsigned i = 0; i < xors.size(); ++i) {
+            bool parity = false;
+            for (unsigned j = 0; j < xors[i].m_vars.size(); ++j)
+                parity ^= m[xors[i].m_vars[j]] == l_true;
+            ENSURE(parity == xors[i].m_parity);
+        }
+    }
+}
+
+void tst_sat_xor() {
+    for (unsigned seed = 0; seed < 20; ++seed) {
+        tst_xor(seed, 60, 50, 0);
+        tst_xor(seed, 80, 50, 120);
+    }
+}
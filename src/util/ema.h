@@ -0,0 +1,41 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    ema.h
+
+Abstract:
+
+    Exponential moving average.
+
+    The average starts from zero, and the resulting bias towards
+    zero is corrected by dividing with 1 - (1 - alpha)^n after
+    n updates, so that early values are not underestimated.
+
+Revision History:
+
+--*/
+#ifndef EMA_H_
+#define EMA_H_
+
+class ema {
+    double m_alpha;
+    double m_value;
+    double m_beta;   // (1 - alpha)^n
+public:
+    ema(): m_alpha(0), m_value(0), m_beta(1) {}
+    ema(double alpha): m_alpha(alpha), m_value(0), m_beta(1) {}
+
+    void set_alpha(double alpha) { m_alpha = alpha; reset(); }
+    void reset() { m_value = 0; m_beta = 1; }
+
+    void update(double x) {
+        m_value += m_alpha * (x - m_value);
+        m_beta  *= 1 - m_alpha;
+    }
+
+    operator double() const { return m_beta == 1 ? 0 : m_value / (1 - m_beta); }
+};
+
+#endif